@@ -2,16 +2,139 @@
 
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import display
-from esphome.const import CONF_ID, CONF_DISPLAY_ID, CONF_UPDATE_INTERVAL, CONF_URL
+from esphome.components import display, web_server_base
+from esphome.components.web_server_base import CONF_WEB_SERVER_BASE_ID
+import esphome.final_validate as fv
+from esphome.const import (
+    CONF_ID, CONF_DISPLAY_ID, CONF_UPDATE_INTERVAL, CONF_URL, CONF_PORT,
+    CONF_X, CONF_Y, CONF_WIDTH, CONF_HEIGHT, CONF_TYPE, CONF_DURATION,
+)
 
 DEPENDENCIES = ["display", "api"]
 CODEOWNERS = ["@votre_nom_utilisateur"]
+# Plusieurs lecteurs peuvent partager le même moteur vidéo
+MULTI_CONF = True
 
 video_player_ns = cg.esphome_ns.namespace("video_player")
 VideoPlayerComponent = video_player_ns.class_("VideoPlayerComponent", cg.Component)
+BandwidthArbiter = video_player_ns.class_("BandwidthArbiter")
+SyncRole = video_player_ns.enum("SyncRole", is_class=True)
+PlaybackMode = video_player_ns.enum("PlaybackMode", is_class=True)
+TransitionType = video_player_ns.enum("TransitionType", is_class=True)
+
+PLAYBACK_MODES = {
+    "forward": PlaybackMode.FORWARD,
+    "reverse": PlaybackMode.REVERSE,
+    "ping_pong": PlaybackMode.PING_PONG,
+}
+
+TRANSITION_TYPES = {
+    "none": TransitionType.NONE,
+    "crossfade": TransitionType.CROSSFADE,
+    "wipe": TransitionType.WIPE,
+    "slide": TransitionType.SLIDE,
+}
+
+SYNC_ROLES = {
+    "leader": SyncRole.LEADER,
+    "follower": SyncRole.FOLLOWER,
+}
 
 CONF_VIDEO_PATH = "video_path"
+CONF_FAT_PATH = "fat_path"
+CONF_VIDEO_PLAYER_ID = "video_player_id"
+CONF_MEMORY_BUDGET = "memory_budget"
+CONF_MOSAIC = "mosaic"
+CONF_COLUMNS = "columns"
+CONF_ROWS = "rows"
+CONF_CELL = "cell"
+CONF_SYNC = "sync"
+CONF_ROLE = "role"
+CONF_GROUP = "group"
+CONF_PLAYBACK_MODE = "playback_mode"
+CONF_FRAME_CACHE_SIZE = "frame_cache_size"
+CONF_PALETTE_MODE = "palette_mode"
+CONF_ALPHA_MATTE = "alpha_matte"
+CONF_OUTPUTS = "outputs"
+CONF_CPU_BUDGET = "cpu_budget"
+CONF_LOOP = "loop"
+CONF_DECODER = "decoder"
+CONF_DECODER_BENCHMARK_FRAMES = "decoder_benchmark_frames"
+
+DECODERS = ["auto", "builtin", "tjpgd", "hardware"]
+CONF_FRAME_LAYOUT = "frame_layout"
+FRAME_LAYOUTS = ["linear", "tiled"]
+CONF_KEEP_LAST_FRAME = "keep_last_frame"
+CONF_IDLE_MEMORY_FLOOR = "idle_memory_floor"
+CONF_SOURCE = "source"
+CONF_SNAPSHOT = "snapshot"
+CONF_TRANSITION = "transition"
+CONF_PATH = "path"
+CONF_AUTOTUNE = "autotune"
+CONF_BAND_HEIGHT = "band_height"
+CONF_FRAMES = "frames"
+CONF_BANDWIDTH = "bandwidth"
+CONF_LINK_RATE = "link_rate"
+CONF_WEIGHT = "weight"
+CONF_MAX_RATE = "max_rate"
+
+
+def validate_mosaic(config):
+    if config[CONF_CELL] >= config[CONF_COLUMNS] * config[CONF_ROWS]:
+        raise cv.Invalid("cell must be smaller than columns * rows")
+    return config
+
+
+MOSAIC_SCHEMA = cv.All(
+    cv.Schema({
+        cv.Required(CONF_COLUMNS): cv.int_range(min=1, max=8),
+        cv.Required(CONF_ROWS): cv.int_range(min=1, max=8),
+        cv.Required(CONF_CELL): cv.int_range(min=0, max=63),
+    }),
+    validate_mosaic,
+)
+
+TRANSITION_SCHEMA = cv.Schema({
+    cv.Required(CONF_TYPE): cv.enum(TRANSITION_TYPES, lower=True),
+    cv.Optional(CONF_DURATION, default="500ms"): cv.positive_time_period_milliseconds,
+})
+
+SNAPSHOT_SCHEMA = cv.Schema({
+    # Servi par le serveur web existant (composant web_server)
+    cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(web_server_base.WebServerBase),
+    cv.Optional(CONF_PATH, default="/snapshot.jpg"): cv.string,
+})
+
+AUTOTUNE_SCHEMA = cv.Schema({
+    # Frames mesurés par configuration candidate
+    cv.Optional(CONF_FRAMES, default=8): cv.int_range(min=2, max=60),
+})
+
+BANDWIDTH_SCHEMA = cv.Schema({
+    # Débit total du lien, global : partagé avec tous les clients de l'arbitre
+    # (octets/s), une seule valeur pour tous les lecteurs
+    cv.Optional(CONF_LINK_RATE): cv.int_range(min=16 * 1024),
+    # Part de la vidéo parmi les transferts actifs (WebDAV, OTA...)
+    cv.Optional(CONF_WEIGHT, default=2): cv.int_range(min=1, max=255),
+    cv.Optional(CONF_MAX_RATE, default=0): cv.int_range(min=0),
+})
+
+OUTPUT_SCHEMA = cv.Schema({
+    cv.Required(CONF_DISPLAY_ID): cv.use_id(display.DisplayBuffer),
+    # Fenêtre de la vidéo affichée sur cet écran (vidéo entière si absente)
+    cv.Optional(CONF_SOURCE): cv.Schema({
+        cv.Required(CONF_X): cv.uint16_t,
+        cv.Required(CONF_Y): cv.uint16_t,
+        cv.Required(CONF_WIDTH): cv.int_range(min=1, max=65535),
+        cv.Required(CONF_HEIGHT): cv.int_range(min=1, max=65535),
+    }),
+})
+
+SYNC_SCHEMA = cv.Schema({
+    cv.Required(CONF_ROLE): cv.enum(SYNC_ROLES, lower=True),
+    cv.Optional(CONF_GROUP, default="239.255.42.42"): cv.ipv4address,
+    cv.Optional(CONF_PORT, default=5042): cv.port,
+})
 
 VIDEO_SCHEMA = cv.Schema({
     cv.Required(CONF_DISPLAY_ID): cv.use_id(display.DisplayBuffer),
@@ -23,9 +146,66 @@ CONFIG_SCHEMA = cv.Schema(
         cv.GenerateID(): cv.declare_id(VideoPlayerComponent),
         cv.Optional(CONF_VIDEO_PATH): cv.string,
         cv.Optional(CONF_URL): cv.url,
+        # Même fichier vu par FatFs ("0:/video.mjpg") : lecture directe des secteurs de la carte SD
+        cv.Optional(CONF_FAT_PATH): cv.string,
+        # Budget global du pool de buffers partagé entre tous les lecteurs (octets)
+        cv.Optional(CONF_MEMORY_BUDGET): cv.int_range(min=16 * 1024),
+        # Cellule de la grille occupée par ce lecteur (écran entier si absent)
+        cv.Optional(CONF_MOSAIC): MOSAIC_SCHEMA,
+        # Horloge média partagée en multicast UDP (mur vidéo)
+        cv.Optional(CONF_SYNC): SYNC_SCHEMA,
+        # Lecture inversée ou aller-retour à partir de l'index des frames
+        cv.Optional(CONF_PLAYBACK_MODE, default="forward"): cv.enum(PLAYBACK_MODES, lower=True),
+        # Frames décodés gardés en mémoire (pris sur le pool partagé)
+        cv.Optional(CONF_FRAME_CACHE_SIZE, default=0): cv.int_range(min=0, max=32),
+        cv.Optional(CONF_PALETTE_MODE, default=False): cv.boolean,
+        # Vidéo détourée (bloc ALPH) : couleur 0xRRGGBB sous les bords semi-transparents
+        cv.Optional(CONF_ALPHA_MATTE, default=0x000000): cv.hex_int_range(min=0, max=0xFFFFFF),
+        # Décodeur JPEG ; "auto" mesure chaque décodeur sur les premiers frames
+        cv.Optional(CONF_DECODER, default="auto"): cv.one_of(*DECODERS, lower=True),
+        cv.Optional(CONF_DECODER_BENCHMARK_FRAMES, default=3): cv.int_range(min=0, max=30),
+        # Frames décodés en tuiles de 16x16 (décodeurs tjpgd et rANS), remis en
+        # lignes pendant l'envoi à l'écran
+        cv.Optional(CONF_FRAME_LAYOUT, default="linear"): cv.one_of(*FRAME_LAYOUTS, lower=True),
+        # Lignes envoyées à l'écran par bande
+        cv.Optional(CONF_BAND_HEIGHT, default=16): cv.int_range(min=1, max=256),
+        # Calibration de la bande et de la disposition sur l'appareil, résultat gardé en flash
+        cv.Optional(CONF_AUTOTUNE): AUTOTUNE_SCHEMA,
+        # Sans boucle, la fin de la vidéo met le lecteur en veille comme une pause
+        cv.Optional(CONF_LOOP, default=True): cv.boolean,
+        # En pause : garder le frame affiché (redessin sous les sprites)
+        cv.Optional(CONF_KEEP_LAST_FRAME, default=False): cv.boolean,
+        # En pause : mémoire du pool conservée pour une reprise rapide (octets)
+        cv.Optional(CONF_IDLE_MEMORY_FLOOR, default=0): cv.int_range(min=0),
+        # Part maximale du cœur pour la lecture, moyennée sur 1 s
+        cv.Optional(CONF_CPU_BUDGET): cv.percentage,
+        # Mur d'écrans : un décodage, plusieurs écrans (remplace la zone d'affichage)
+        cv.Optional(CONF_OUTPUTS): cv.ensure_list(OUTPUT_SCHEMA),
+        # Instantané HTTP : le JPEG du frame affiché, sans décodage ni copie
+        cv.Optional(CONF_SNAPSHOT): SNAPSHOT_SCHEMA,
+        # Passage d'un clip au suivant (play_file) : fondu, volet ou glissement
+        cv.Optional(CONF_TRANSITION): TRANSITION_SCHEMA,
+        # Source HTTP : débit de la lecture anticipée quand d'autres transferts tournent
+        cv.Optional(CONF_BANDWIDTH): BANDWIDTH_SCHEMA,
     }
 ).extend(VIDEO_SCHEMA).extend(cv.COMPONENT_SCHEMA)
 
+
+def _final_validate(config):
+    # Le débit du lien appartient à l'arbitre, unique : les lecteurs qui le
+    # donnent doivent tous donner le même
+    rates = {
+        player[CONF_BANDWIDTH][CONF_LINK_RATE]
+        for player in fv.full_config.get().get("video_player", [])
+        if CONF_LINK_RATE in player.get(CONF_BANDWIDTH, {})
+    }
+    if len(rates) > 1:
+        raise cv.Invalid(f"bandwidth: {CONF_LINK_RATE} is global, all video players must use the same value")
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
@@ -34,10 +214,69 @@ async def to_code(config):
     cg.add(var.set_display(display_))
     
     if CONF_VIDEO_PATH in config:
-        cg.add(var.set_video_path(config[CONF_VIDEO_PATH]))
+        cg.add(var.set_file_path(config[CONF_VIDEO_PATH]))
+    if CONF_FAT_PATH in config:
+        cg.add(var.set_fat_path(config[CONF_FAT_PATH]))
     
     if CONF_URL in config:
         cg.add(var.set_http_url(config[CONF_URL]))
     
     if CONF_UPDATE_INTERVAL in config:
         cg.add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+    
+    if CONF_MEMORY_BUDGET in config:
+        cg.add(var.set_memory_budget(config[CONF_MEMORY_BUDGET]))
+    
+    if CONF_MOSAIC in config:
+        mosaic = config[CONF_MOSAIC]
+        cg.add(var.set_mosaic(mosaic[CONF_COLUMNS], mosaic[CONF_ROWS], mosaic[CONF_CELL]))
+    
+    cg.add(var.set_playback_mode(config[CONF_PLAYBACK_MODE]))
+    cg.add(var.set_frame_cache_size(config[CONF_FRAME_CACHE_SIZE]))
+    cg.add(var.set_palette_mode(config[CONF_PALETTE_MODE]))
+    cg.add(var.set_alpha_matte(config[CONF_ALPHA_MATTE]))
+    
+    cg.add(var.set_loop(config[CONF_LOOP]))
+    cg.add(var.set_decoder(config[CONF_DECODER]))
+    cg.add(var.set_decoder_benchmark_frames(config[CONF_DECODER_BENCHMARK_FRAMES]))
+    cg.add(var.set_tiled_layout(config[CONF_FRAME_LAYOUT] == "tiled"))
+    cg.add(var.set_band_height(config[CONF_BAND_HEIGHT]))
+    if CONF_AUTOTUNE in config:
+        cg.add(var.set_autotune(True, config[CONF_AUTOTUNE][CONF_FRAMES]))
+    cg.add(var.set_keep_last_frame(config[CONF_KEEP_LAST_FRAME]))
+    cg.add(var.set_idle_memory_floor(config[CONF_IDLE_MEMORY_FLOOR]))
+    
+    if CONF_CPU_BUDGET in config:
+        cg.add(var.set_cpu_budget(config[CONF_CPU_BUDGET]))
+    
+    for output in config.get(CONF_OUTPUTS, []):
+        output_display = await cg.get_variable(output[CONF_DISPLAY_ID])
+        source = output.get(CONF_SOURCE)
+        if source is None:
+            cg.add(var.add_output(output_display, 0, 0, 0, 0))
+        else:
+            cg.add(var.add_output(output_display, source[CONF_X], source[CONF_Y],
+                                  source[CONF_WIDTH], source[CONF_HEIGHT]))
+    
+    if CONF_TRANSITION in config:
+        transition = config[CONF_TRANSITION]
+        cg.add(var.set_transition(transition[CONF_TYPE], transition[CONF_DURATION]))
+    # Chaque lecteur est un client distinct de l'arbitre réseau
+    cg.add(var.set_network_name(str(config[CONF_ID])))
+    if CONF_BANDWIDTH in config:
+        bandwidth = config[CONF_BANDWIDTH]
+        cg.add(var.set_bandwidth(bandwidth[CONF_WEIGHT], bandwidth[CONF_MAX_RATE]))
+        if CONF_LINK_RATE in bandwidth:
+            arbiter = cg.MockObj(f"{BandwidthArbiter}::get()", "->")
+            cg.add(arbiter.set_link_rate(bandwidth[CONF_LINK_RATE]))
+    
+    if CONF_SNAPSHOT in config:
+        snapshot = config[CONF_SNAPSHOT]
+        web_server = await cg.get_variable(snapshot[CONF_WEB_SERVER_BASE_ID])
+        cg.add(var.set_web_server(web_server))
+        cg.add_define("USE_VIDEO_PLAYER_SNAPSHOT")
+        cg.add(var.set_snapshot_path(snapshot[CONF_PATH]))
+    
+    if CONF_SYNC in config:
+        sync = config[CONF_SYNC]
+        cg.add(var.set_sync(sync[CONF_ROLE], str(sync[CONF_GROUP]), sync[CONF_PORT]))
@@ -0,0 +1,127 @@
+#include "bandwidth_arbiter.h"
+#include "esphome/core/log.h"
+
+#include "esp_timer.h"
+
+#include <string.h>
+#include <algorithm>
+
+namespace esphome {
+namespace video_player {
+
+static const char *TAG = "bandwidth_arbiter";
+
+// Un client sans demande depuis ce délai ne compte plus dans le partage
+static const int64_t ACTIVE_WINDOW_US = 1000000;
+// Rafale autorisée : ce que le seau accumule au plus, en temps de débit
+static const int64_t BURST_US = 250000;
+// Plancher du seau, pour qu'une petite part permette encore un bloc entier
+static const uint32_t MIN_BURST_BYTES = 4096;
+
+BandwidthArbiter *BandwidthArbiter::get() {
+  // Instance unique, créée au premier client
+  static BandwidthArbiter *instance = new BandwidthArbiter();
+  return instance;
+}
+
+BandwidthArbiter::BandwidthArbiter() { this->mutex_ = xSemaphoreCreateMutex(); }
+
+int BandwidthArbiter::register_client(const char *name, uint8_t weight, uint32_t max_rate) {
+  xSemaphoreTake(this->mutex_, portMAX_DELAY);
+  int index = -1;
+  for (size_t i = 0; i < this->clients_.size(); i++) {
+    if (strcmp(this->clients_[i].name, name) == 0) {
+      index = i;
+      break;
+    }
+  }
+  if (index < 0) {
+    index = this->clients_.size();
+    this->clients_.push_back(Client{name, 1, 0, false, 0, esp_timer_get_time(), 0});
+  }
+  this->clients_[index].weight = std::max<uint8_t>(weight, 1);
+  this->clients_[index].max_rate = max_rate;
+  const size_t count = this->clients_.size();
+  xSemaphoreGive(this->mutex_);
+  ESP_LOGD(TAG, "Client '%s' registered (weight %d, %d client(s))", name, weight, count);
+  return index;
+}
+
+void BandwidthArbiter::set_active(int client, bool active) {
+  xSemaphoreTake(this->mutex_, portMAX_DELAY);
+  if (client >= 0 && client < (int) this->clients_.size()) {
+    this->clients_[client].active = active;
+  }
+  xSemaphoreGive(this->mutex_);
+}
+
+bool BandwidthArbiter::is_active(const Client &client, int64_t now) const {
+  return client.active || (client.last_request_us != 0 && now - client.last_request_us < ACTIVE_WINDOW_US);
+}
+
+uint32_t BandwidthArbiter::share_of(int client, int64_t now) const {
+  // Part du lien au prorata des poids des clients actifs (le demandeur compris)
+  uint32_t total_weight = 0;
+  bool alone = true;
+  for (size_t i = 0; i < this->clients_.size(); i++) {
+    if ((int) i == client || this->is_active(this->clients_[i], now)) {
+      total_weight += this->clients_[i].weight;
+      alone &= (int) i == client;
+    }
+  }
+  const Client &self = this->clients_[client];
+  if (alone) {
+    return self.max_rate;
+  }
+  const uint32_t share = (uint64_t) this->link_rate_ * self.weight / total_weight;
+  return self.max_rate > 0 ? std::min(share, self.max_rate) : share;
+}
+
+size_t BandwidthArbiter::acquire(int client, size_t bytes) {
+  xSemaphoreTake(this->mutex_, portMAX_DELAY);
+  if (client < 0 || client >= (int) this->clients_.size() || bytes == 0) {
+    xSemaphoreGive(this->mutex_);
+    return 0;
+  }
+  const int64_t now = esp_timer_get_time();
+  Client &self = this->clients_[client];
+  const uint32_t rate = this->share_of(client, now);
+  size_t granted;
+  if (rate == 0) {
+    // Seul et sans plafond : aucune limite, le seau reste plein
+    granted = bytes;
+    self.tokens = 0;
+  } else {
+    // Remplir le seau depuis la dernière demande, dans la limite de la rafale
+    const uint32_t burst = std::max<uint32_t>((uint64_t) rate * BURST_US / 1000000, MIN_BURST_BYTES);
+    const uint64_t refill = (uint64_t) rate * (now - self.last_refill_us) / 1000000;
+    self.tokens = std::min<uint64_t>(self.tokens + refill, burst);
+    granted = std::min<size_t>(bytes, self.tokens);
+    self.tokens -= granted;
+  }
+  self.last_refill_us = now;
+  self.last_request_us = now;
+  xSemaphoreGive(this->mutex_);
+  return granted;
+}
+
+void BandwidthArbiter::release(int client, size_t unused) {
+  xSemaphoreTake(this->mutex_, portMAX_DELAY);
+  if (client >= 0 && client < (int) this->clients_.size()) {
+    this->clients_[client].tokens += unused;
+  }
+  xSemaphoreGive(this->mutex_);
+}
+
+uint32_t BandwidthArbiter::get_rate(int client) {
+  xSemaphoreTake(this->mutex_, portMAX_DELAY);
+  uint32_t rate = 0;
+  if (client >= 0 && client < (int) this->clients_.size()) {
+    rate = this->share_of(client, esp_timer_get_time());
+  }
+  xSemaphoreGive(this->mutex_);
+  return rate;
+}
+
+}  // namespace video_player
+}  // namespace esphome
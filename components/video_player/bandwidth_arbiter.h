@@ -0,0 +1,67 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace esphome {
+namespace video_player {
+
+// Arbitre du débit réseau, partagé par tous les composants gourmands
+// (lecteurs vidéo, WebDAV, OTA...). Chaque client a un seau à jetons dont le
+// débit est sa part du lien, au prorata de son poids parmi les clients actifs.
+// Un client seul n'est pas limité ; dès qu'un autre transfert démarre, la
+// lecture anticipée de la vidéo ralentit et son buffer absorbe la différence.
+class BandwidthArbiter {
+ public:
+  static BandwidthArbiter *get();
+
+  // Débit total du lien à partager (octets/s)
+  void set_link_rate(uint32_t bytes_per_second) { this->link_rate_ = bytes_per_second; }
+  uint32_t get_link_rate() const { return this->link_rate_; }
+
+  // Enregistrer un client (ou retrouver celui qui porte déjà ce nom, chaîne
+  // statique). Le poids fixe la part du lien, `max_rate` la plafonne (0 = sans
+  // plafond).
+  int register_client(const char *name, uint8_t weight, uint32_t max_rate = 0);
+
+  // Transfert en cours / terminé, pour les clients qui ne passent pas par
+  // acquire() à chaque bloc (sinon l'activité est déduite des demandes)
+  void set_active(int client, bool active);
+
+  // Demander `bytes` octets ; renvoie ce qui peut être transféré tout de
+  // suite (0 si le seau est vide), sans jamais bloquer
+  size_t acquire(int client, size_t bytes);
+  // Rendre la partie d'une demande accordée qui n'a pas été transférée
+  void release(int client, size_t unused);
+
+  // Débit actuellement attribué (0 = client seul, non limité)
+  uint32_t get_rate(int client);
+  size_t get_client_count() const { return this->clients_.size(); }
+
+ protected:
+  BandwidthArbiter();
+
+  struct Client {
+    const char *name;
+    uint8_t weight;
+    uint32_t max_rate;
+    bool active;
+    int64_t last_request_us;
+    int64_t last_refill_us;
+    uint32_t tokens;
+  };
+
+  bool is_active(const Client &client, int64_t now) const;
+  uint32_t share_of(int client, int64_t now) const;
+
+  SemaphoreHandle_t mutex_{nullptr};
+  std::vector<Client> clients_;
+  uint32_t link_rate_{1000000};
+};
+
+}  // namespace video_player
+}  // namespace esphome
@@ -0,0 +1,254 @@
+#include "clock_sync.h"
+#include "esphome/core/log.h"
+
+#include "esp_timer.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+namespace esphome {
+namespace video_player {
+
+static const char *TAG = "video_sync";
+
+// "VSYN" en little-endian
+static const uint32_t SYNC_MAGIC = 0x4E595356;
+// Balises du leader et requêtes de délai des followers, une fois par seconde
+static const int64_t SYNC_PERIOD_US = 1000000;
+// Balises manquées avant qu'un follower ne se considère désynchronisé
+static const int64_t SYNC_MISSED_BEACONS = 3;
+
+enum SyncPacketType : uint8_t {
+  SYNC_BEACON = 1,     // leader -> groupe : époque média
+  SYNC_DELAY_REQ = 2,  // follower -> leader : t1
+  SYNC_DELAY_RESP = 3  // leader -> follower : t1, t2, t3
+};
+
+// Structure d'un paquet de synchronisation (horloges en µs)
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint8_t type;
+  int64_t t1;           // envoi de la requête (horloge du follower)
+  int64_t t2;           // réception de la requête (horloge du leader)
+  int64_t t3;           // envoi de la réponse (horloge du leader)
+  int64_t media_epoch;  // temps média 0 (horloge du leader)
+} sync_packet_t;
+
+ClockSync::ClockSync(SyncRole role, const char *group, uint16_t port) : role_(role), group_(group), port_(port) {}
+
+ClockSync::~ClockSync() { this->stop(); }
+
+int64_t ClockSync::now_us() const { return esp_timer_get_time(); }
+
+bool ClockSync::start() {
+  if (this->socket_ >= 0) {
+    return true;
+  }
+
+  int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock < 0) {
+    ESP_LOGE(TAG, "Failed to create UDP socket");
+    return false;
+  }
+
+  // Permettre plusieurs instances sur la même machine (tests en loopback)
+  int enable = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+#ifdef SO_REUSEPORT
+  setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+#endif
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(this->port_);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+    ESP_LOGE(TAG, "Failed to bind UDP port %u", this->port_);
+    close(sock);
+    return false;
+  }
+
+  struct ip_mreq mreq = {};
+  mreq.imr_multiaddr.s_addr = inet_addr(this->group_);
+  mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+  if (setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+    ESP_LOGE(TAG, "Failed to join multicast group %s", this->group_);
+    close(sock);
+    return false;
+  }
+  uint8_t loop = 1;
+  setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+  // poll() ne doit jamais bloquer la boucle principale
+  fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+
+  this->socket_ = sock;
+  if (this->role_ == SyncRole::LEADER) {
+    // Le leader définit le temps média : il démarre maintenant
+    this->media_epoch_us_ = this->now_us();
+    this->epoch_known_ = true;
+    this->synced_ = true;
+  }
+  ESP_LOGI(TAG, "Clock sync started as %s on %s:%u", this->role_ == SyncRole::LEADER ? "leader" : "follower",
+           this->group_, this->port_);
+  return true;
+}
+
+void ClockSync::stop() {
+  if (this->socket_ >= 0) {
+    close(this->socket_);
+    this->socket_ = -1;
+  }
+}
+
+void ClockSync::poll() {
+  if (this->socket_ < 0) {
+    return;
+  }
+
+  uint8_t buffer[64];
+  int len;
+  while ((len = recv(this->socket_, buffer, sizeof(buffer), 0)) > 0) {
+    this->handle_packet(buffer, len);
+  }
+
+  const int64_t now = this->now_us();
+  if (this->role_ == SyncRole::FOLLOWER && this->leader_known_ &&
+      now - this->last_leader_us_ > SYNC_MISSED_BEACONS * SYNC_PERIOD_US) {
+    this->lose_leader();
+  }
+  if (now - this->last_send_us_ < SYNC_PERIOD_US) {
+    return;
+  }
+  this->last_send_us_ = now;
+
+  if (this->role_ == SyncRole::LEADER) {
+    this->send(SYNC_BEACON, 0, 0);
+  } else if (this->leader_known_) {
+    this->pending_t1_ = now;
+    this->send(SYNC_DELAY_REQ, now, 0);
+  }
+}
+
+void ClockSync::handle_packet(const uint8_t *data, size_t len) {
+  const int64_t received = this->now_us();
+  if (len != sizeof(sync_packet_t)) {
+    return;
+  }
+  sync_packet_t packet;
+  memcpy(&packet, data, sizeof(packet));
+  if (packet.magic != SYNC_MAGIC) {
+    return;
+  }
+
+  if (this->role_ == SyncRole::LEADER) {
+    // Répondre aux requêtes de délai ; ignorer nos propres balises
+    if (packet.type == SYNC_DELAY_REQ) {
+      this->send(SYNC_DELAY_RESP, packet.t1, received);
+    }
+    return;
+  }
+
+  switch (packet.type) {
+    case SYNC_BEACON:
+      if (!this->leader_known_) {
+        ESP_LOGI(TAG, "Leader found");
+      }
+      this->leader_known_ = true;
+      this->last_leader_us_ = received;
+      this->media_epoch_us_ = packet.media_epoch;
+      this->epoch_known_ = true;
+      break;
+    case SYNC_DELAY_RESP: {
+      // Réponse à un autre follower, ou à une requête déjà traitée
+      if (packet.t1 != this->pending_t1_ || this->pending_t1_ == 0) {
+        break;
+      }
+      this->pending_t1_ = 0;
+      // NTP : offset = ((t2 - t1) + (t3 - t4)) / 2, délai = (t4 - t1) - (t3 - t2)
+      const int64_t t4 = received;
+      const int64_t offset = ((packet.t2 - packet.t1) + (packet.t3 - t4)) / 2;
+      const int64_t delay = (t4 - packet.t1) - (packet.t3 - packet.t2);
+      if (delay >= 0) {
+        this->add_sample(offset, delay);
+      }
+      this->last_leader_us_ = received;
+      this->media_epoch_us_ = packet.media_epoch;
+      this->epoch_known_ = true;
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void ClockSync::send(uint8_t type, int64_t t1, int64_t t2) {
+  struct sockaddr_in group = {};
+  group.sin_family = AF_INET;
+  group.sin_port = htons(this->port_);
+  group.sin_addr.s_addr = inet_addr(this->group_);
+  sync_packet_t packet = {};
+  packet.magic = SYNC_MAGIC;
+  packet.type = type;
+  packet.t1 = t1;
+  packet.t2 = t2;
+  packet.media_epoch = this->media_epoch_us_;
+  // t3 au plus près de l'envoi effectif
+  packet.t3 = this->now_us();
+  sendto(this->socket_, &packet, sizeof(packet), 0, (const struct sockaddr *) &group, sizeof(group));
+}
+
+void ClockSync::add_sample(int64_t offset_us, int64_t delay_us) {
+  this->samples_[this->sample_next_] = Sample{offset_us, delay_us};
+  this->sample_next_ = (this->sample_next_ + 1) % SAMPLE_COUNT;
+  if (this->sample_count_ < SAMPLE_COUNT) {
+    this->sample_count_++;
+  }
+
+  // Filtre NTP classique : l'échantillon au plus petit délai est le moins perturbé
+  const Sample *best = &this->samples_[0];
+  for (size_t i = 1; i < this->sample_count_; i++) {
+    if (this->samples_[i].delay_us < best->delay_us) {
+      best = &this->samples_[i];
+    }
+  }
+  this->offset_us_ = best->offset_us;
+  this->delay_us_ = best->delay_us;
+
+  if (!this->synced_) {
+    ESP_LOGI(TAG, "Synchronised to leader: offset %lld us, delay %lld us", (long long) this->offset_us_,
+             (long long) this->delay_us_);
+  }
+  this->synced_ = true;
+}
+
+void ClockSync::lose_leader() {
+  // Le leader s'est tu (arrêt, réseau) : repartir de zéro à sa prochaine balise
+  ESP_LOGW(TAG, "Leader lost after %lld missed beacons", (long long) SYNC_MISSED_BEACONS);
+  this->leader_known_ = false;
+  this->epoch_known_ = false;
+  this->synced_ = false;
+  this->sample_count_ = 0;
+  this->sample_next_ = 0;
+}
+
+bool ClockSync::get_media_time_ms(int64_t *media_ms) const {
+  if (!this->synced_ || !this->epoch_known_) {
+    return false;
+  }
+  // Horloge du leader = horloge locale + offset
+  const int64_t leader_now = this->now_us() + (this->role_ == SyncRole::FOLLOWER ? this->offset_us_ : 0);
+  const int64_t media_us = leader_now - this->media_epoch_us_;
+  if (media_us < 0) {
+    return false;
+  }
+  *media_ms = media_us / 1000;
+  return true;
+}
+
+}  // namespace video_player
+}  // namespace esphome
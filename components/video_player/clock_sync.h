@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esphome {
+namespace video_player {
+
+enum class SyncRole {
+  LEADER,
+  FOLLOWER
+};
+
+// Horloge média partagée entre plusieurs appareils (mur vidéo).
+// Le leader diffuse en multicast l'instant où le temps média 0 a été présenté ;
+// chaque follower estime l'écart entre son horloge et celle du leader à la
+// manière de NTP (échanges t1..t4) et en déduit le temps média courant.
+// Tous les paquets passent par le groupe (une réponse est reconnue à son t1) :
+// plusieurs instances sur la même machine partagent le port sans ambiguïté.
+// N'utilise que des sockets BSD.
+class ClockSync {
+ public:
+  ClockSync(SyncRole role, const char *group, uint16_t port);
+  virtual ~ClockSync();
+
+  bool start();
+  void stop();
+  bool is_started() const { return this->socket_ >= 0; }
+
+  // Traiter les paquets reçus et les envois périodiques, sans bloquer
+  void poll();
+
+  // Temps média courant en millisecondes (64 bits : pas de retour à zéro au
+  // bout de 49 jours), faux tant qu'on n'est pas synchronisé
+  bool get_media_time_ms(int64_t *media_ms) const;
+
+  SyncRole get_role() const { return this->role_; }
+  bool is_synced() const { return this->synced_; }
+  int64_t get_offset_us() const { return this->offset_us_; }
+  int64_t get_delay_us() const { return this->delay_us_; }
+
+ protected:
+  struct Sample {
+    int64_t offset_us;
+    int64_t delay_us;
+  };
+
+  // Horloge locale ; virtuelle pour les tests hôtes (horloges décalées)
+  virtual int64_t now_us() const;
+  void lose_leader();
+  void handle_packet(const uint8_t *data, size_t len);
+  void send(uint8_t type, int64_t t1, int64_t t2);
+  void add_sample(int64_t offset_us, int64_t delay_us);
+
+  SyncRole role_;
+  const char *group_;
+  uint16_t port_;
+  int socket_{-1};
+
+  // Leader entendu (follower) et t1 de la requête de délai en attente
+  bool leader_known_{false};
+  int64_t pending_t1_{0};
+  // Dernier paquet reçu du leader : sans nouvelles, la synchronisation tombe
+  int64_t last_leader_us_{0};
+
+  // Instant (horloge du leader, µs) où le temps média 0 a été présenté
+  int64_t media_epoch_us_{0};
+  bool epoch_known_{false};
+
+  // Estimation d'écart : on garde l'échantillon de plus petit délai aller-retour
+  static const size_t SAMPLE_COUNT = 8;
+  Sample samples_[SAMPLE_COUNT]{};
+  size_t sample_count_{0};
+  size_t sample_next_{0};
+  int64_t offset_us_{0};
+  int64_t delay_us_{0};
+  bool synced_{false};
+
+  int64_t last_send_us_{0};
+};
+
+}  // namespace video_player
+}  // namespace esphome
@@ -0,0 +1,87 @@
+#include "decoder_backend.h"
+#include "rgb565.h"
+
+#include <string.h>
+#include <algorithm>
+
+extern "C" {
+bool jpg2rgb565(const uint8_t *src, size_t src_len, uint8_t *out, jpg_scale_t scale);
+bool jpg2rgb565_available(void);
+}
+
+namespace esphome {
+namespace video_player {
+
+bool BuiltinDecoderBackend::decode(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out,
+                                   uint32_t width, uint32_t height) {
+  return jpg2rgb565(jpeg_data, jpeg_size, out, scale);
+}
+
+bool BuiltinDecoderBackend::is_available() const { return jpg2rgb565_available(); }
+
+bool TjpgdDecoderBackend::is_available() const { return esp_jpg_decode_available(); }
+
+namespace {
+
+struct TjpgdContext {
+  const uint8_t *jpeg_data;
+  uint16_t *out;
+  uint32_t width;
+  uint32_t height;
+  bool tiled;
+};
+
+size_t tjpgd_read(void *arg, size_t index, uint8_t *buf, size_t len) {
+  // buf == nullptr : le décodeur saute des données
+  if (buf != nullptr) {
+    memcpy(buf, static_cast<TjpgdContext *>(arg)->jpeg_data + index, len);
+  }
+  return len;
+}
+
+bool tjpgd_write(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+  // data == nullptr : notifications de début et de fin d'image
+  if (data == nullptr) {
+    return true;
+  }
+  auto *context = static_cast<TjpgdContext *>(arg);
+  // Bloc RGB888 -> RGB565, en ignorant ce qui dépasse (largeur non multiple du
+  // MCU, ou image plus grande que la sortie demandée)
+  if (x >= context->width || y >= context->height) {
+    return true;
+  }
+  const uint16_t cols = std::min<uint32_t>(w, context->width - x);
+  const uint16_t rows = std::min<uint32_t>(h, context->height - y);
+  for (uint16_t row = 0; row < rows; row++) {
+    const uint8_t *src = data + (size_t) row * w * 3;
+    if (context->tiled) {
+      // Le bloc (8 ou 16 pixels de côté) tombe dans une ou deux tuiles
+      for (uint16_t col = 0; col < cols; col++, src += 3) {
+        context->out[tiled_pixel_index(x + col, y + row, context->width)] = rgb565(src[0], src[1], src[2]);
+      }
+      continue;
+    }
+    uint16_t *dst = context->out + (y + row) * context->width + x;
+    for (uint16_t col = 0; col < cols; col++, src += 3) {
+      dst[col] = rgb565(src[0], src[1], src[2]);
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool TjpgdDecoderBackend::decode(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out,
+                                 uint32_t width, uint32_t height) {
+  TjpgdContext context{jpeg_data, (uint16_t *) out, width, height, false};
+  return esp_jpg_decode(jpeg_size, scale, tjpgd_read, tjpgd_write, &context) == ESP_OK;
+}
+
+bool TjpgdDecoderBackend::decode_tiled(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out,
+                                       uint32_t width, uint32_t height) {
+  TjpgdContext context{jpeg_data, (uint16_t *) out, width, height, true};
+  return esp_jpg_decode(jpeg_size, scale, tjpgd_read, tjpgd_write, &context) == ESP_OK;
+}
+
+}  // namespace video_player
+}  // namespace esphome
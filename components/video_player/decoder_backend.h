@@ -0,0 +1,72 @@
+#pragma once
+
+#include "esp_jpg_decode.h"
+#include "frame_ref.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+namespace esphome {
+namespace video_player {
+
+// Décodeur JPEG -> RGB565. La sortie fait exactement width x height pixels
+// (dimensions de la vidéo réduites par l'échelle DCT demandée).
+class DecoderBackend {
+ public:
+  virtual ~DecoderBackend() = default;
+  virtual const char *get_name() const = 0;
+  // Compilé pour cette cible (tjpgd n'est en ROM que sur l'ESP32)
+  virtual bool is_available() const { return true; }
+  virtual bool decode(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+                      uint32_t height) = 0;
+  // Sortie en tuiles (PixelFormat::RGB565_TILED, tiled_frame_pixels() pixels),
+  // pour les décodeurs qui écrivent bloc par bloc
+  virtual bool supports_tiled() const { return false; }
+  virtual bool decode_tiled(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out,
+                            uint32_t width, uint32_t height) {
+    return false;
+  }
+};
+
+// Décodeur intégré : le point d'entrée historique jpg2rgb565()
+class BuiltinDecoderBackend : public DecoderBackend {
+ public:
+  const char *get_name() const override { return "builtin"; }
+  bool is_available() const override;
+  bool decode(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+              uint32_t height) override;
+};
+
+// tjpgd (ROM de l'ESP32) via esp_jpg_decode(), converti en RGB565 bloc par bloc
+class TjpgdDecoderBackend : public DecoderBackend {
+ public:
+  const char *get_name() const override { return "tjpgd"; }
+  bool is_available() const override;
+  bool decode(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+              uint32_t height) override;
+  bool supports_tiled() const override { return true; }
+  bool decode_tiled(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+                    uint32_t height) override;
+};
+
+// Point d'accroche pour un décodeur matériel fourni par l'application
+using HardwareDecodeFunction =
+    std::function<bool(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+                       uint32_t height)>;
+
+class HardwareDecoderBackend : public DecoderBackend {
+ public:
+  explicit HardwareDecoderBackend(HardwareDecodeFunction function) : function_(std::move(function)) {}
+  const char *get_name() const override { return "hardware"; }
+  bool decode(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+              uint32_t height) override {
+    return this->function_(jpeg_data, jpeg_size, scale, out, width, height);
+  }
+
+ protected:
+  HardwareDecodeFunction function_;
+};
+
+}  // namespace video_player
+}  // namespace esphome
@@ -1,5 +1,12 @@
 // esp_jpg_decode.c
 #include "esp_jpg_decode.h"
+#include "sdkconfig.h"
+
+// Décodeur tjpgd présent en ROM sur l'ESP32
+#if CONFIG_IDF_TARGET_ESP32
+#include "esp32/rom/tjpgd.h"
+#define JPG_HAS_ROM_TJPGD 1
+#endif
 
 bool jpg2rgb565(const uint8_t *src, size_t src_len, uint8_t *out, jpg_scale_t scale) {
     // Implementation of JPG to RGB565 conversion
@@ -11,3 +18,94 @@ bool jpg2rgb565(const uint8_t *src, size_t src_len, uint8_t *out, jpg_scale_t sc
     // Simple placeholder implementation (does nothing, returns false)
     return false;
 }
+
+bool jpg2rgb565_available(void) {
+    // A passer à true avec une vraie implémentation de jpg2rgb565()
+    return false;
+}
+
+#ifdef JPG_HAS_ROM_TJPGD
+
+typedef struct {
+    jpg_scale_t scale;
+    jpg_reader_cb reader;
+    jpg_writer_cb writer;
+    void * arg;
+    size_t len;
+    size_t index;
+} esp_jpg_decoder_t;
+
+// Zone de travail de tjpgd : un seul décodage à la fois (boucle principale)
+static uint8_t jpg_work[3100];
+
+static uint32_t _jpg_read(JDEC *decoder, uint8_t *buf, uint32_t len)
+{
+    esp_jpg_decoder_t * jpeg = (esp_jpg_decoder_t *)decoder->device;
+    if (jpeg->len && len > (jpeg->len - jpeg->index)) {
+        len = jpeg->len - jpeg->index;
+    }
+    if (len) {
+        len = jpeg->reader(jpeg->arg, jpeg->index, buf, len);
+        jpeg->index += len;
+    }
+    return len;
+}
+
+static uint32_t _jpg_write(JDEC *decoder, void *bitmap, JRECT *rect)
+{
+    esp_jpg_decoder_t * jpeg = (esp_jpg_decoder_t *)decoder->device;
+    uint16_t x = rect->left;
+    uint16_t y = rect->top;
+    uint16_t w = rect->right + 1 - x;
+    uint16_t h = rect->bottom + 1 - y;
+    return jpeg->writer(jpeg->arg, x, y, w, h, (uint8_t *)bitmap) ? 1 : 0;
+}
+
+esp_err_t esp_jpg_decode(size_t len, jpg_scale_t scale, jpg_reader_cb reader, jpg_writer_cb writer, void * arg)
+{
+    JDEC decoder;
+    esp_jpg_decoder_t jpeg;
+
+    jpeg.len = len;
+    jpeg.reader = reader;
+    jpeg.writer = writer;
+    jpeg.arg = arg;
+    jpeg.scale = scale;
+    jpeg.index = 0;
+
+    JRESULT jres = jd_prepare(&decoder, _jpg_read, jpg_work, sizeof(jpg_work), &jpeg);
+    if (jres != JDR_OK) {
+        return ESP_FAIL;
+    }
+
+    uint16_t output_width = decoder.width / (1 << (uint8_t)(jpeg.scale));
+    uint16_t output_height = decoder.height / (1 << (uint8_t)(jpeg.scale));
+
+    // Début de l'image
+    writer(arg, 0, 0, output_width, output_height, NULL);
+    jres = jd_decomp(&decoder, _jpg_write, (uint8_t)jpeg.scale);
+    // Fin de l'image
+    writer(arg, output_width, output_height, output_width, output_height, NULL);
+
+    return jres == JDR_OK ? ESP_OK : ESP_FAIL;
+}
+
+bool esp_jpg_decode_available(void)
+{
+    return true;
+}
+
+#else
+
+esp_err_t esp_jpg_decode(size_t len, jpg_scale_t scale, jpg_reader_cb reader, jpg_writer_cb writer, void * arg)
+{
+    // Pas de tjpgd en ROM sur cette cible
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+bool esp_jpg_decode_available(void)
+{
+    return false;
+}
+
+#endif
@@ -36,6 +36,9 @@ typedef bool (* jpg_writer_cb)(void * arg, uint16_t x, uint16_t y, uint16_t w, u
 
 esp_err_t esp_jpg_decode(size_t len, jpg_scale_t scale, jpg_reader_cb reader, jpg_writer_cb writer, void * arg);
 
+// Faux sur les cibles sans tjpgd en ROM (tout sauf l'ESP32 d'origine)
+bool esp_jpg_decode_available(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,95 @@
+#include "frame_ref.h"
+#include "video_engine.h"
+
+#include <string.h>
+
+namespace esphome {
+namespace video_player {
+
+FrameRef::FrameRef(const FrameRef &other) : control_(other.control_) {
+  if (this->control_ != nullptr) {
+    this->control_->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+FrameRef::FrameRef(FrameRef &&other) noexcept : control_(other.control_) { other.control_ = nullptr; }
+
+FrameRef &FrameRef::operator=(const FrameRef &other) {
+  if (this != &other) {
+    FrameRef copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+FrameRef &FrameRef::operator=(FrameRef &&other) noexcept {
+  if (this != &other) {
+    this->reset();
+    this->control_ = other.control_;
+    other.control_ = nullptr;
+  }
+  return *this;
+}
+
+FrameRef FrameRef::from_pool(size_t size) {
+  uint8_t *data = VideoEngine::get()->acquire_buffer(size);
+  if (data == nullptr) {
+    return FrameRef();
+  }
+  return FrameRef(new Control{{1}, data, size, true, data, {}, {}});
+}
+
+FrameRef FrameRef::from_pool(size_t capacity, size_t offset, size_t size) {
+  if (offset + size > capacity) {
+    return FrameRef();
+  }
+  uint8_t *block = VideoEngine::get()->acquire_buffer(capacity);
+  if (block == nullptr) {
+    return FrameRef();
+  }
+  return FrameRef(new Control{{1}, block + offset, size, true, block, {}, {}});
+}
+
+FrameRef FrameRef::from_pool_aligned(size_t size, size_t alignment) {
+  uint8_t *block = VideoEngine::get()->acquire_buffer(size + alignment - 1);
+  if (block == nullptr) {
+    return FrameRef();
+  }
+  const size_t offset = (alignment - (uintptr_t) block % alignment) % alignment;
+  return FrameRef(new Control{{1}, block + offset, size, true, block, {}, {}});
+}
+
+FrameRef FrameRef::borrow(const uint8_t *data, size_t size) {
+  return FrameRef(new Control{{1}, const_cast<uint8_t *>(data), size, false, nullptr, {}, {}});
+}
+
+FrameRef FrameRef::extract(size_t offset, size_t size) const {
+  if (this->control_ == nullptr || offset + size > this->control_->size) {
+    return FrameRef();
+  }
+  if (!this->control_->pooled) {
+    return FrameRef::borrow(this->control_->data + offset, size);
+  }
+  FrameRef part = FrameRef::from_pool(size);
+  if (part) {
+    memcpy(part.mutable_data(), this->control_->data + offset, size);
+  }
+  return part;
+}
+
+void FrameRef::reset() {
+  if (this->control_ == nullptr) {
+    return;
+  }
+  // Dernière référence : le bloc retourne au pool
+  if (this->control_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    if (this->control_->pooled) {
+      VideoEngine::get()->release_buffer(this->control_->block);
+    }
+    delete this->control_;
+  }
+  this->control_ = nullptr;
+}
+
+}  // namespace video_player
+}  // namespace esphome
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esphome {
+namespace video_player {
+
+// Format des pixels d'un frame décodé en mémoire
+enum class PixelFormat {
+  RGB565,
+  INDEXED8,     // index dans la palette de la vidéo, 1 octet par pixel
+  RGB565_TILED  // RGB565 en tuiles de 16x16 pixels (voir tiled_pixel_index)
+};
+
+// Disposition en tuiles : chaque tuile de 16x16 pixels occupe 512 octets
+// contigus (16 lignes de cache de 32 octets), les tuiles se suivent ligne de
+// tuiles par ligne de tuiles. Un bloc MCU décodé touche une seule tuile au
+// lieu de 8 ou 16 lignes éloignées de tout un frame en PSRAM.
+static const uint32_t FRAME_TILE_SIZE = 16;
+static const size_t FRAME_TILE_ALIGN = 32;
+
+static inline size_t tiled_frame_pixels(uint32_t width, uint32_t height) {
+  return (size_t) ((width + FRAME_TILE_SIZE - 1) / FRAME_TILE_SIZE) *
+         ((height + FRAME_TILE_SIZE - 1) / FRAME_TILE_SIZE) * FRAME_TILE_SIZE * FRAME_TILE_SIZE;
+}
+
+static inline size_t tiled_pixel_index(uint32_t x, uint32_t y, uint32_t width) {
+  const uint32_t tiles_per_row = (width + FRAME_TILE_SIZE - 1) / FRAME_TILE_SIZE;
+  return (((size_t) (y >> 4) * tiles_per_row + (x >> 4)) << 8) | ((y & 15) << 4) | (x & 15);
+}
+
+enum FrameFlags : uint8_t {
+  FRAME_ENCODED = 1 << 0,  // données JPEG
+  FRAME_DECODED = 1 << 1,  // pixels au format `format`
+  FRAME_PREVIEW = 1 << 2,  // décodage DC seulement (aperçu, vignette)
+};
+
+// Métadonnées partagées par toutes les références à un même frame
+struct FrameInfo {
+  uint32_t index{0};
+  uint32_t timestamp{0};
+  uint32_t width{0};
+  uint32_t height{0};
+  PixelFormat format{PixelFormat::RGB565};
+  uint8_t flags{0};
+};
+
+// Poignée partagée sur un frame en mémoire : une zone de données, un compteur
+// de références et des métadonnées. Sources, décodeurs et caches se passent
+// le même frame sans copie. La mémoire empruntée au pool du moteur y retourne
+// à la dernière référence ; la mémoire d'un autre propriétaire (buffer HTTP,
+// fichier projeté) n'est jamais libérée par la poignée.
+// Le compteur est atomique et le pool verrouillé : la dernière référence peut
+// tomber dans n'importe quelle tâche (serveur HTTP, passerelle).
+class FrameRef {
+ public:
+  FrameRef() = default;
+  FrameRef(const FrameRef &other);
+  FrameRef(FrameRef &&other) noexcept;
+  FrameRef &operator=(const FrameRef &other);
+  FrameRef &operator=(FrameRef &&other) noexcept;
+  ~FrameRef() { this->reset(); }
+
+  // Nouveau bloc du pool partagé ; poignée vide si le budget est épuisé
+  static FrameRef from_pool(size_t size);
+  // Bloc du pool de `capacity` octets dont le frame n'occupe que [offset, offset + size)
+  // (lectures par secteurs entiers directement dans le bloc)
+  static FrameRef from_pool(size_t capacity, size_t offset, size_t size);
+  // Bloc du pool dont les données commencent sur une frontière de `alignment` octets
+  static FrameRef from_pool_aligned(size_t size, size_t alignment);
+  // Alias non propriétaire sur une mémoire qui vit plus longtemps que le frame
+  static FrameRef borrow(const uint8_t *data, size_t size);
+  // Sous-partie du frame : alias si la mémoire n'appartient pas au pool,
+  // sinon copie compacte (le bloc complet n'a pas à rester réservé)
+  FrameRef extract(size_t offset, size_t size) const;
+
+  explicit operator bool() const { return this->control_ != nullptr; }
+  const uint8_t *data() const;
+  uint8_t *mutable_data() const;
+  size_t size() const;
+  uint32_t use_count() const;
+  // Uniquement sur une poignée non vide
+  FrameInfo &info();
+  const FrameInfo &info() const;
+
+  // Frame annexe partagé avec celui-ci (masque alpha d'un frame décodé)
+  void attach(const FrameRef &other);
+  const FrameRef &attached() const;
+
+  void reset();
+
+ protected:
+  struct Control;
+
+  explicit FrameRef(Control *control) : control_(control) {}
+
+  Control *control_{nullptr};
+};
+
+struct FrameRef::Control {
+  std::atomic<uint32_t> refs;
+  uint8_t *data;
+  size_t size;
+  bool pooled;
+  uint8_t *block;  // début du bloc du pool (peut précéder data)
+  FrameInfo info;
+  FrameRef attached;
+};
+
+inline const uint8_t *FrameRef::data() const { return this->control_ ? this->control_->data : nullptr; }
+inline uint8_t *FrameRef::mutable_data() const { return this->control_ ? this->control_->data : nullptr; }
+inline size_t FrameRef::size() const { return this->control_ ? this->control_->size : 0; }
+inline uint32_t FrameRef::use_count() const { return this->control_ ? this->control_->refs.load() : 0; }
+inline FrameInfo &FrameRef::info() { return this->control_->info; }
+inline const FrameInfo &FrameRef::info() const { return this->control_->info; }
+inline void FrameRef::attach(const FrameRef &other) { this->control_->attached = other; }
+inline const FrameRef &FrameRef::attached() const { return this->control_->attached; }
+
+}  // namespace video_player
+}  // namespace esphome
@@ -0,0 +1,45 @@
+"""Réglages d'image du lecteur vidéo exposés comme entités number."""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import number
+from esphome.const import CONF_TYPE
+
+from .. import CONF_VIDEO_PLAYER_ID, VideoPlayerComponent, video_player_ns
+
+DEPENDENCIES = ["video_player"]
+
+VideoAdjustmentNumber = video_player_ns.class_(
+    "VideoAdjustmentNumber", number.Number, cg.Component
+)
+AdjustmentType = video_player_ns.enum("AdjustmentType", is_class=True)
+
+# type: (valeur C++, min, max, pas)
+ADJUSTMENTS = {
+    "brightness": (AdjustmentType.BRIGHTNESS, -1.0, 1.0, 0.01),
+    "contrast": (AdjustmentType.CONTRAST, 0.0, 2.0, 0.01),
+    "gamma": (AdjustmentType.GAMMA, 0.2, 3.0, 0.05),
+}
+
+CONFIG_SCHEMA = (
+    number.number_schema(VideoAdjustmentNumber)
+    .extend(
+        {
+            cv.GenerateID(CONF_VIDEO_PLAYER_ID): cv.use_id(VideoPlayerComponent),
+            cv.Required(CONF_TYPE): cv.one_of(*ADJUSTMENTS, lower=True),
+        }
+    )
+    .extend(cv.COMPONENT_SCHEMA)
+)
+
+
+async def to_code(config):
+    adjustment, min_value, max_value, step = ADJUSTMENTS[config[CONF_TYPE]]
+    var = await number.new_number(
+        config, min_value=min_value, max_value=max_value, step=step
+    )
+    await cg.register_component(var, config)
+
+    parent = await cg.get_variable(config[CONF_VIDEO_PLAYER_ID])
+    cg.add(var.set_parent(parent))
+    cg.add(var.set_type(adjustment))
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/number/number.h"
+#include "esphome/components/video_player/video_player.h"
+
+namespace esphome {
+namespace video_player {
+
+enum class AdjustmentType {
+  BRIGHTNESS,
+  CONTRAST,
+  GAMMA
+};
+
+// Réglage d'image modifiable en direct pendant la lecture
+class VideoAdjustmentNumber : public number::Number, public Component {
+ public:
+  void setup() override {
+    // Publier la valeur courante du lecteur
+    this->publish_state(this->get_value());
+  }
+
+  void set_parent(VideoPlayerComponent *parent) { this->parent_ = parent; }
+  void set_type(AdjustmentType type) { this->type_ = type; }
+
+ protected:
+  void control(float value) override {
+    switch (this->type_) {
+      case AdjustmentType::BRIGHTNESS:
+        this->parent_->set_brightness(value);
+        break;
+      case AdjustmentType::CONTRAST:
+        this->parent_->set_contrast(value);
+        break;
+      case AdjustmentType::GAMMA:
+        this->parent_->set_gamma(value);
+        break;
+    }
+    this->publish_state(value);
+  }
+
+  float get_value() const {
+    switch (this->type_) {
+      case AdjustmentType::BRIGHTNESS:
+        return this->parent_->get_brightness();
+      case AdjustmentType::CONTRAST:
+        return this->parent_->get_contrast();
+      default:
+        return this->parent_->get_gamma();
+    }
+  }
+
+  VideoPlayerComponent *parent_{nullptr};
+  AdjustmentType type_{AdjustmentType::BRIGHTNESS};
+};
+
+}  // namespace video_player
+}  // namespace esphome
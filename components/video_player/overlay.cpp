@@ -0,0 +1,114 @@
+#include "overlay.h"
+#include "rgb565.h"
+#include "esphome/core/log.h"
+
+#include "esp_heap_caps.h"
+
+#include <string.h>
+#include <algorithm>
+
+namespace esphome {
+namespace video_player {
+
+static const char *TAG = "video_overlay";
+
+static void *overlay_alloc(size_t size) {
+  // Les sprites sont petits et lus à chaque ligne : mémoire interne d'abord
+  void *ptr = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if (!ptr) {
+    ptr = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  }
+  return ptr;
+}
+
+OverlaySprite::OverlaySprite(int x, int y, uint16_t width, uint16_t height, OverlayMask mask)
+    : x_(x), y_(y), width_(width), height_(height), mask_(mask) {
+  const size_t mask_size = mask == OverlayMask::BINARY ? ((width + 7) / 8) * height : (size_t) width * height;
+  this->pixels_ = (uint16_t *) overlay_alloc((size_t) width * height * 2);
+  this->mask_data_ = (uint8_t *) overlay_alloc(mask_size);
+  if (!this->pixels_ || !this->mask_data_) {
+    ESP_LOGE(TAG, "Failed to allocate %dx%d sprite", width, height);
+    heap_caps_free(this->pixels_);
+    heap_caps_free(this->mask_data_);
+    this->pixels_ = nullptr;
+    this->mask_data_ = nullptr;
+    return;
+  }
+  this->clear();
+}
+
+OverlaySprite::~OverlaySprite() {
+  heap_caps_free(this->pixels_);
+  heap_caps_free(this->mask_data_);
+}
+
+void OverlaySprite::clear() {
+  if (!this->mask_data_) {
+    return;
+  }
+  const size_t mask_size =
+      this->mask_ == OverlayMask::BINARY ? ((this->width_ + 7) / 8) * this->height_ : (size_t) this->width_ * this->height_;
+  memset(this->mask_data_, 0, mask_size);
+}
+
+void OverlaySprite::set_pixel(int x, int y, Color color, uint8_t alpha) {
+  if (!this->pixels_ || x < 0 || y < 0 || x >= this->width_ || y >= this->height_) {
+    return;
+  }
+  this->pixels_[y * this->width_ + x] = rgb565(color.r, color.g, color.b);
+  if (this->mask_ == OverlayMask::BINARY) {
+    uint8_t &bits = this->mask_data_[y * ((this->width_ + 7) / 8) + x / 8];
+    if (alpha >= 128) {
+      bits |= 0x80 >> (x & 7);
+    } else {
+      bits &= ~(0x80 >> (x & 7));
+    }
+  } else {
+    this->mask_data_[y * this->width_ + x] = alpha;
+  }
+}
+
+void OverlaySprite::render_if_dirty() {
+  if (!this->dirty_ || !this->pixels_) {
+    return;
+  }
+  this->dirty_ = false;
+  if (this->renderer_) {
+    this->clear();
+    this->renderer_(*this);
+  }
+}
+
+void OverlaySprite::composite_row(uint16_t *dst, int dst_x, int width, int y) const {
+  // Intersection horizontale entre le sprite et la portion de ligne fournie
+  const int start = std::max(this->x_, dst_x);
+  const int end = std::min(this->x_ + (int) this->width_, dst_x + width);
+  if (start >= end) {
+    return;
+  }
+
+  const int row = y - this->y_;
+  const uint16_t *src = this->pixels_ + row * this->width_;
+  if (this->mask_ == OverlayMask::BINARY) {
+    const uint8_t *bits = this->mask_data_ + row * ((this->width_ + 7) / 8);
+    for (int x = start; x < end; x++) {
+      const int sx = x - this->x_;
+      if (bits[sx >> 3] & (0x80 >> (sx & 7))) {
+        dst[x - dst_x] = src[sx];
+      }
+    }
+  } else {
+    const uint8_t *alpha = this->mask_data_ + row * this->width_;
+    for (int x = start; x < end; x++) {
+      const int sx = x - this->x_;
+      const uint8_t a = alpha[sx];
+      if (a == 0) {
+        continue;
+      }
+      dst[x - dst_x] = a == 255 ? src[sx] : rgb565_blend(src[sx], dst[x - dst_x], (a + 4) >> 3);
+    }
+  }
+}
+
+}  // namespace video_player
+}  // namespace esphome
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "esphome/core/color.h"
+
+#include <stdint.h>
+#include <functional>
+
+namespace esphome {
+namespace video_player {
+
+enum class OverlayMask : uint8_t {
+  BINARY,  // 1 bit par pixel : opaque ou transparent
+  ALPHA    // 8 bits par pixel : bords adoucis
+};
+
+// Sprite pré-rendu au format de l'écran (RGB565), composé sur la vidéo
+// pendant le blit, uniquement sur les lignes qu'il recouvre. Son contenu
+// n'est redessiné (par le renderer) qu'après un appel à invalidate().
+class OverlaySprite {
+ public:
+  OverlaySprite(int x, int y, uint16_t width, uint16_t height, OverlayMask mask = OverlayMask::BINARY);
+  ~OverlaySprite();
+  // Les buffers heap_caps appartiennent au sprite : une copie les libérerait deux fois
+  OverlaySprite(const OverlaySprite &) = delete;
+  OverlaySprite &operator=(const OverlaySprite &) = delete;
+
+  void set_position(int x, int y) {
+    this->x_ = x;
+    this->y_ = y;
+  }
+  void set_visible(bool visible) { this->visible_ = visible; }
+  void set_renderer(std::function<void(OverlaySprite &)> &&renderer) {
+    this->renderer_ = std::move(renderer);
+    this->dirty_ = true;
+  }
+  // Le contenu a changé : il sera redessiné avant le prochain blit
+  void invalidate() { this->dirty_ = true; }
+  bool is_dirty() const { return this->visible_ && this->dirty_; }
+
+  // Primitives utilisées par le renderer
+  void clear();
+  void set_pixel(int x, int y, Color color, uint8_t alpha = 255);
+
+  void render_if_dirty();
+  bool covers_row(int y) const { return this->visible_ && this->pixels_ && y >= this->y_ && y < this->y_ + this->height_; }
+  // Composer la ligne y de l'écran ; dst couvre les colonnes [dst_x, dst_x + width)
+  void composite_row(uint16_t *dst, int dst_x, int width, int y) const;
+
+ protected:
+  int x_;
+  int y_;
+  uint16_t width_;
+  uint16_t height_;
+  OverlayMask mask_;
+  uint16_t *pixels_{nullptr};
+  uint8_t *mask_data_{nullptr};
+  bool visible_{true};
+  bool dirty_{true};
+  std::function<void(OverlaySprite &)> renderer_;
+};
+
+}  // namespace video_player
+}  // namespace esphome
@@ -0,0 +1,394 @@
+#include "rans_decoder.h"
+#include "rgb565.h"
+#include "esphome/core/log.h"
+
+#include "esp_heap_caps.h"
+
+#include <string.h>
+#include <algorithm>
+
+namespace esphome {
+namespace video_player {
+
+static const char *TAG = "video_rans";
+
+// Borne basse de l'état rANS : renormalisation octet par octet
+static const uint32_t RANS_LOWER = 1u << 23;
+
+// Position naturelle du k-ième coefficient en ordre zigzag
+static const uint8_t ZIGZAG[64] = {
+    0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,  12, 19, 26, 33, 40, 48,
+    41, 34, 27, 20, 13, 6,  7,  14, 21, 28, 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23,
+    30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+namespace {
+
+struct RansStream {
+  uint32_t state;
+  const uint8_t *ptr;
+  const uint8_t *end;
+  // Flux épuisé avant la fin du frame : frame corrompu ou tronqué
+  bool exhausted{false};
+
+  // Une recherche dans la table, une multiplication, puis renormalisation
+  inline uint8_t decode(const uint16_t *freq, const uint16_t *cum, const uint8_t *symbols) {
+    const uint32_t slot = this->state & 0xFFF;
+    const uint8_t s = symbols[slot];
+    this->state = freq[s] * (this->state >> 12) + slot - cum[s];
+    while (this->state < RANS_LOWER) {
+      if (this->ptr == this->end) {
+        this->exhausted = true;
+        break;
+      }
+      this->state = (this->state << 8) | *this->ptr++;
+    }
+    return s;
+  }
+};
+
+struct BitReader {
+  const uint8_t *ptr;
+  const uint8_t *end;
+  uint32_t bits{0};
+  int count{0};
+
+  inline uint32_t get(int n) {
+    while (this->count < n) {
+      this->bits = (this->bits << 8) | (this->ptr < this->end ? *this->ptr++ : 0);
+      this->count += 8;
+    }
+    this->count -= n;
+    return (this->bits >> this->count) & ((1u << n) - 1);
+  }
+};
+
+// Magnitude JPEG : n bits, les valeurs basses codent les négatifs
+inline int extend(uint32_t value, int n) {
+  return value < (1u << (n - 1)) ? (int) value - (1 << n) + 1 : (int) value;
+}
+
+inline uint8_t clamp8(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+// IDCT entière 8x8 (algorithme de Loeffler, constantes sur 12 bits), même
+// précision que l'IDCT « islow » des décodeurs JPEG
+#define F2F(x) ((int) ((x) * 4096 + 0.5f))
+#define IDCT_1D(s0, s1, s2, s3, s4, s5, s6, s7) \
+  int t0, t1, t2, t3, p1, p2, p3, p4, p5, x0, x1, x2, x3; \
+  p2 = s2; \
+  p3 = s6; \
+  p1 = (p2 + p3) * F2F(0.5411961f); \
+  t2 = p1 + p3 * F2F(-1.847759065f); \
+  t3 = p1 + p2 * F2F(0.765366865f); \
+  p2 = s0; \
+  p3 = s4; \
+  t0 = (p2 + p3) * 4096; \
+  t1 = (p2 - p3) * 4096; \
+  x0 = t0 + t3; \
+  x3 = t0 - t3; \
+  x1 = t1 + t2; \
+  x2 = t1 - t2; \
+  t0 = s7; \
+  t1 = s5; \
+  t2 = s3; \
+  t3 = s1; \
+  p3 = t0 + t2; \
+  p4 = t1 + t3; \
+  p1 = t0 + t3; \
+  p2 = t1 + t2; \
+  p5 = (p3 + p4) * F2F(1.175875602f); \
+  t0 = t0 * F2F(0.298631336f); \
+  t1 = t1 * F2F(2.053119869f); \
+  t2 = t2 * F2F(3.072711026f); \
+  t3 = t3 * F2F(1.501321110f); \
+  p1 = p5 + p1 * F2F(-0.899976223f); \
+  p2 = p5 + p2 * F2F(-2.562915447f); \
+  p3 = p3 * F2F(-1.961570560f); \
+  p4 = p4 * F2F(-0.390180644f); \
+  t3 += p1 + p4; \
+  t2 += p2 + p3; \
+  t1 += p2 + p4; \
+  t0 += p1 + p3;
+
+void idct_block(const int16_t *in, uint8_t *out, int out_stride) {
+  int v[64];
+  // Colonnes
+  for (int i = 0; i < 8; i++) {
+    const int16_t *d = in + i;
+    int *w = v + i;
+    if (d[8] == 0 && d[16] == 0 && d[24] == 0 && d[32] == 0 && d[40] == 0 && d[48] == 0 && d[56] == 0) {
+      // Colonne sans AC : valeur constante
+      const int dc = d[0] * 4;
+      w[0] = w[8] = w[16] = w[24] = w[32] = w[40] = w[48] = w[56] = dc;
+      continue;
+    }
+    IDCT_1D(d[0], d[8], d[16], d[24], d[32], d[40], d[48], d[56])
+    x0 += 512;
+    x1 += 512;
+    x2 += 512;
+    x3 += 512;
+    w[0] = (x0 + t3) >> 10;
+    w[56] = (x0 - t3) >> 10;
+    w[8] = (x1 + t2) >> 10;
+    w[48] = (x1 - t2) >> 10;
+    w[16] = (x2 + t1) >> 10;
+    w[40] = (x2 - t1) >> 10;
+    w[24] = (x3 + t0) >> 10;
+    w[32] = (x3 - t0) >> 10;
+  }
+  // Lignes, avec le décalage de niveau +128
+  for (int i = 0; i < 8; i++) {
+    const int *w = v + i * 8;
+    uint8_t *o = out + i * out_stride;
+    IDCT_1D(w[0], w[1], w[2], w[3], w[4], w[5], w[6], w[7])
+    x0 += 65536 + (128 << 17);
+    x1 += 65536 + (128 << 17);
+    x2 += 65536 + (128 << 17);
+    x3 += 65536 + (128 << 17);
+    o[0] = clamp8((x0 + t3) >> 17);
+    o[7] = clamp8((x0 - t3) >> 17);
+    o[1] = clamp8((x1 + t2) >> 17);
+    o[6] = clamp8((x1 - t2) >> 17);
+    o[2] = clamp8((x2 + t1) >> 17);
+    o[5] = clamp8((x2 - t1) >> 17);
+    o[3] = clamp8((x3 + t0) >> 17);
+    o[4] = clamp8((x3 - t0) >> 17);
+  }
+}
+
+// IDCT réduite : les n x n coefficients basse fréquence du bloc 8x8 (n = 4
+// ou 2) donnent directement un bloc de n x n pixels, chacun la moyenne de son
+// voisinage. Pas de repliement comme en gardant un pixel sur 2 ou 4, et le
+// calcul (6 ou 2 multiplications par passe 1D) est une fraction de l'IDCT 8x8
+static const int K0 = F2F(0.353553391f);  // cos(pi/4) / 2
+static const int K1 = F2F(0.461939766f);  // cos(pi/8) / 2
+static const int K3 = F2F(0.191341716f);  // cos(3pi/8) / 2
+
+void idct_reduced(const int16_t *in, uint8_t *out, int out_stride, int n) {
+  int v[16];
+  // Colonnes, sur une précision de 1 bit
+  for (int i = 0; i < n; i++) {
+    const int16_t *d = in + i;
+    int *w = v + i;
+    if (n == 4) {
+      const int e0 = (d[0] + d[16]) * K0;
+      const int e1 = (d[0] - d[16]) * K0;
+      const int o0 = d[8] * K1 + d[24] * K3;
+      const int o1 = d[8] * K3 - d[24] * K1;
+      w[0] = (e0 + o0 + 1024) >> 11;
+      w[4] = (e1 + o1 + 1024) >> 11;
+      w[8] = (e1 - o1 + 1024) >> 11;
+      w[12] = (e0 - o0 + 1024) >> 11;
+    } else {
+      w[0] = ((d[0] + d[8]) * K0 + 1024) >> 11;
+      w[2] = ((d[0] - d[8]) * K0 + 1024) >> 11;
+    }
+  }
+  // Lignes, avec le décalage de niveau +128
+  const int bias = 4096 + (128 << 13);
+  for (int i = 0; i < n; i++) {
+    const int *w = v + i * n;
+    uint8_t *o = out + i * out_stride;
+    if (n == 4) {
+      const int e0 = (w[0] + w[2]) * K0 + bias;
+      const int e1 = (w[0] - w[2]) * K0 + bias;
+      const int o0 = w[1] * K1 + w[3] * K3;
+      const int o1 = w[1] * K3 - w[3] * K1;
+      o[0] = clamp8((e0 + o0) >> 13);
+      o[1] = clamp8((e1 + o1) >> 13);
+      o[2] = clamp8((e1 - o1) >> 13);
+      o[3] = clamp8((e0 - o0) >> 13);
+    } else {
+      o[0] = clamp8(((w[0] + w[1]) * K0 + bias) >> 13);
+      o[1] = clamp8(((w[0] - w[1]) * K0 + bias) >> 13);
+    }
+  }
+}
+
+#undef IDCT_1D
+#undef F2F
+
+}  // namespace
+
+RansDecoderBackend::~RansDecoderBackend() {
+  if (this->models_ != nullptr) {
+    heap_caps_free(this->models_);
+  }
+}
+
+bool RansDecoderBackend::load_tables(const uint8_t *chunk, size_t size) {
+  const uint8_t *p = chunk;
+  const uint8_t *end = chunk + size;
+  if (size < 4 + sizeof(this->qt_) || p[0] != 1 || p[1] != 0) {
+    ESP_LOGE(TAG, "Unsupported RANS chunk (version %d, subsampling %d)", size > 0 ? p[0] : -1,
+             size > 1 ? p[1] : -1);
+    return false;
+  }
+  p += 4;
+  memcpy(this->qt_, p, sizeof(this->qt_));
+  p += sizeof(this->qt_);
+  
+  if (this->models_ == nullptr) {
+    // Tables lues pour chaque symbole : mémoire interne en priorité
+    const size_t models_size = MODEL_COUNT * sizeof(Model);
+    this->models_ = (Model *) heap_caps_malloc(models_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!this->models_) {
+      this->models_ = (Model *) heap_caps_malloc(models_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+      if (!this->models_) {
+        ESP_LOGE(TAG, "Failed to allocate rANS tables");
+        return false;
+      }
+    }
+  }
+  
+  for (int m = 0; m < MODEL_COUNT; m++) {
+    Model &model = this->models_[m];
+    memset(model.freq, 0, sizeof(model.freq));
+    if (end - p < 2) {
+      return false;
+    }
+    const uint16_t count = p[0] | (p[1] << 8);
+    p += 2;
+    if (end - p < count * 3) {
+      return false;
+    }
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < count; i++, p += 3) {
+      model.freq[p[0]] = p[1] | (p[2] << 8);
+    }
+    for (int s = 0; s < 256; s++) {
+      model.cum[s] = total;
+      if (total + model.freq[s] > PROB_SCALE) {
+        ESP_LOGE(TAG, "rANS model %d: frequencies exceed %u", m, PROB_SCALE);
+        return false;
+      }
+      memset(model.symbol + total, s, model.freq[s]);
+      total += model.freq[s];
+    }
+    if (total != PROB_SCALE) {
+      ESP_LOGE(TAG, "rANS model %d: frequencies sum to %u instead of %u", m, total, PROB_SCALE);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RansDecoderBackend::decode_frame(const uint8_t *data, size_t size, jpg_scale_t scale, uint8_t *out,
+                                      uint32_t width, uint32_t height, bool tiled) {
+  if (this->models_ == nullptr || size < 8 + 4) {
+    return false;
+  }
+  const uint32_t frame_width = data[0] | (data[1] << 8);
+  const uint32_t frame_height = data[2] | (data[3] << 8);
+  uint32_t rans_size;
+  memcpy(&rans_size, data + 4, sizeof(rans_size));
+  if (rans_size < 4 || 8 + rans_size > size) {
+    return false;
+  }
+  
+  RansStream rans{0, data + 8, data + 8 + rans_size};
+  memcpy(&rans.state, rans.ptr, sizeof(rans.state));
+  rans.ptr += sizeof(rans.state);
+  if (rans.state < RANS_LOWER) {
+    ESP_LOGV(TAG, "Invalid rANS initial state 0x%08x", (unsigned) rans.state);
+    return false;
+  }
+  BitReader bits{data + 8 + rans_size, data + size};
+  
+  // Pixels par côté de bloc à cette échelle
+  const int n = 8 >> (int) scale;
+  const uint32_t mcu_columns = (frame_width + 15) / 16;
+  const uint32_t mcu_rows = (frame_height + 15) / 16;
+  int16_t coef[64];
+  uint8_t y_pixels[16 * 16];
+  uint8_t cb_pixels[64];
+  uint8_t cr_pixels[64];
+  int pred[3] = {0, 0, 0};
+  uint16_t *dst = (uint16_t *) out;
+  
+  for (uint32_t mcu_y = 0; mcu_y < mcu_rows; mcu_y++) {
+    for (uint32_t mcu_x = 0; mcu_x < mcu_columns; mcu_x++) {
+      // 4 blocs Y, puis Cb et Cr
+      for (int b = 0; b < 6; b++) {
+        const int component = b < 4 ? 0 : b - 3;
+        const bool luma = component == 0;
+        const Model &dc = this->models_[luma ? DC_LUMA : DC_CHROMA];
+        const Model &ac = this->models_[luma ? AC_LUMA : AC_CHROMA];
+        const uint8_t *qt = this->qt_[luma ? 0 : 1];
+        
+        memset(coef, 0, sizeof(coef));
+        const int dc_size = rans.decode(dc.freq, dc.cum, dc.symbol);
+        if (dc_size > 11) {
+          return false;
+        }
+        if (dc_size > 0) {
+          pred[component] += extend(bits.get(dc_size), dc_size);
+        }
+        coef[0] = pred[component] * qt[0];
+        for (int k = 1; k < 64;) {
+          const uint8_t rs = rans.decode(ac.freq, ac.cum, ac.symbol);
+          const int run = rs >> 4;
+          const int ac_size = rs & 0x0F;
+          if (ac_size == 0) {
+            if (run != 15) {
+              break;  // fin de bloc
+            }
+            k += 16;
+            continue;
+          }
+          k += run;
+          if (k > 63 || ac_size > 10) {
+            ESP_LOGV(TAG, "Corrupt block in MCU (%u,%u)", mcu_x, mcu_y);
+            return false;
+          }
+          coef[ZIGZAG[k]] = extend(bits.get(ac_size), ac_size) * qt[k];
+          k++;
+        }
+        if (rans.exhausted) {
+          ESP_LOGV(TAG, "rANS stream exhausted in MCU (%u,%u)", mcu_x, mcu_y);
+          return false;
+        }
+        
+        // Bloc de n x n pixels à cette échelle : IDCT complète, réduite, ou
+        // à 1/8 le DC seul
+        uint8_t *target = luma ? y_pixels + (b >> 1) * n * 16 + (b & 1) * n : (component == 1 ? cb_pixels : cr_pixels);
+        const int stride = luma ? 16 : 8;
+        if (n == 8) {
+          idct_block(coef, target, stride);
+        } else if (n == 1) {
+          target[0] = clamp8(((coef[0] + 4) >> 3) + 128);
+        } else {
+          idct_reduced(coef, target, stride, n);
+        }
+      }
+      
+      // Conversion YCbCr -> RGB565 du MCU réduit (2n x 2n pixels)
+      const uint32_t mcu_size = 2 * n;
+      for (uint32_t py = 0; py < mcu_size; py++) {
+        const uint32_t oy = mcu_y * mcu_size + py;
+        if (oy >= height) {
+          break;
+        }
+        for (uint32_t px = 0; px < mcu_size; px++) {
+          const uint32_t ox = mcu_x * mcu_size + px;
+          if (ox >= width) {
+            break;
+          }
+          const int c = (py >> 1) * 8 + (px >> 1);
+          const int luma_value = y_pixels[py * 16 + px];
+          const int cb = cb_pixels[c] - 128;
+          const int cr = cr_pixels[c] - 128;
+          const int r = luma_value + ((91881 * cr + 32768) >> 16);
+          const int g = luma_value - ((22554 * cb + 46802 * cr - 32768) >> 16);
+          const int bl = luma_value + ((116130 * cb + 32768) >> 16);
+          const size_t index = tiled ? tiled_pixel_index(ox, oy, width) : oy * width + ox;
+          dst[index] = rgb565(clamp8(r), clamp8(g), clamp8(bl));
+        }
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace video_player
+}  // namespace esphome
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "decoder_backend.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esphome {
+namespace video_player {
+
+// Codec alternatif pour les vidéos préparées par notre outil : les coefficients
+// DCT quantifiés d'un JPEG 4:2:0 (mêmes symboles run/size, mêmes bits de
+// magnitude, transcodage sans perte) sont codés par rANS au lieu de Huffman.
+// Le décodage entropique devient une recherche dans une table par symbole,
+// sans branchement sur la longueur des codes.
+//
+// Bloc "RANS" du conteneur (little-endian) :
+//   uint8 version (1), uint8 sous-échantillonnage (0 = 4:2:0), uint8[2] réservés
+//   uint8 qt[2][64]         tables de quantification luma/chroma (ordre zigzag)
+//   4 modèles (DC luma, AC luma, DC chroma, AC chroma) :
+//     uint16 n, puis n x {uint8 symbole, uint16 fréquence}, somme = 4096
+// Frame :
+//   uint16 largeur, uint16 hauteur, uint32 taille du flux rANS
+//   flux rANS (état initial sur 4 octets, puis octets de renormalisation)
+//   bits de magnitude bruts (poids fort d'abord) jusqu'à la fin du frame
+class RansDecoderBackend : public DecoderBackend {
+ public:
+  ~RansDecoderBackend() override;
+
+  // Tables du clip (contenu du bloc RANS)
+  bool load_tables(const uint8_t *chunk, size_t size);
+
+  const char *get_name() const override { return "rans"; }
+  bool decode(const uint8_t *data, size_t size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+              uint32_t height) override {
+    return this->decode_frame(data, size, scale, out, width, height, false);
+  }
+  bool supports_tiled() const override { return true; }
+  bool decode_tiled(const uint8_t *data, size_t size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+                    uint32_t height) override {
+    return this->decode_frame(data, size, scale, out, width, height, true);
+  }
+
+ protected:
+  bool decode_frame(const uint8_t *data, size_t size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+                    uint32_t height, bool tiled);
+
+  static const uint32_t PROB_BITS = 12;
+  static const uint32_t PROB_SCALE = 1 << PROB_BITS;
+
+  // Modèle de symboles : fréquence et cumul par symbole, et symbole de chaque
+  // position de la plage [0, 4096) pour un décodage par simple lecture de table
+  struct Model {
+    uint16_t freq[256];
+    uint16_t cum[256];
+    uint8_t symbol[PROB_SCALE];
+  };
+
+  enum { DC_LUMA, AC_LUMA, DC_CHROMA, AC_CHROMA, MODEL_COUNT };
+
+  Model *models_{nullptr};
+  uint8_t qt_[2][64];
+};
+
+}  // namespace video_player
+}  // namespace esphome
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace esphome {
+namespace video_player {
+
+// Conversion d'une couleur 8 bits par canal en RGB565
+static inline uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b) {
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+// Mélange de deux pixels RGB565, alpha de 0 (fond) à 32 (premier plan).
+// Les trois canaux sont écartés dans un mot de 32 bits (G en haut, R et B
+// en bas) pour être mélangés en une seule multiplication.
+static inline uint16_t rgb565_blend(uint16_t fg, uint16_t bg, uint32_t alpha) {
+  uint32_t f = (fg | ((uint32_t) fg << 16)) & 0x07E0F81F;
+  uint32_t b = (bg | ((uint32_t) bg << 16)) & 0x07E0F81F;
+  b += ((f - b) * alpha) >> 5;
+  b &= 0x07E0F81F;
+  return (uint16_t) (b | (b >> 16));
+}
+
+// Fondu d'une ligne entière avec un alpha constant : même noyau que
+// rgb565_blend, sans branchement, que le compilateur peut dérouler
+static inline void rgb565_blend_row(uint16_t *dst, const uint16_t *src, int count, uint32_t alpha) {
+  for (int i = 0; i < count; i++) {
+    dst[i] = rgb565_blend(dst[i], src[i], alpha);
+  }
+}
+
+}  // namespace video_player
+}  // namespace esphome
@@ -0,0 +1,114 @@
+#include "sd_extents.h"
+#include "esphome/core/log.h"
+
+#include "ff.h"
+#include "diskio.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace esphome {
+namespace video_player {
+
+static const char *TAG = "video_sd";
+
+bool ExtentReader::open(const char *fat_path) {
+  this->extents_.clear();
+  
+  FIL file;
+  FRESULT res = f_open(&file, fat_path, FA_READ);
+  if (res != FR_OK) {
+    ESP_LOGE(TAG, "Failed to open %s (FatFs error %d)", fat_path, res);
+    return false;
+  }
+  
+  FATFS *fs = file.obj.fs;
+  this->drive_ = fs->pdrv;
+#if FF_MAX_SS != FF_MIN_SS
+  this->sector_size_ = fs->ssize;
+#else
+  this->sector_size_ = FF_MAX_SS;
+#endif
+  this->file_size_ = f_size(&file);
+  const uint32_t cluster_sectors = fs->csize;
+  const uint32_t file_sectors = (this->file_size_ + this->sector_size_ - 1) / this->sector_size_;
+  
+  // Parcourir la chaîne une fois, cluster par cluster : f_lseek avance depuis
+  // le cluster courant et donne le premier secteur du cluster dans `sect`
+  // (positionné un octet après le début pour que FatFs le calcule)
+  for (uint32_t file_sector = 0; file_sector < file_sectors; file_sector += cluster_sectors) {
+    res = f_lseek(&file, (FSIZE_t) file_sector * this->sector_size_ + 1);
+    if (res != FR_OK || file.sect == 0) {
+      ESP_LOGE(TAG, "Failed to resolve cluster at offset %u (FatFs error %d)", file_sector * this->sector_size_,
+               res);
+      f_close(&file);
+      this->extents_.clear();
+      return false;
+    }
+    const uint32_t count = std::min(cluster_sectors, file_sectors - file_sector);
+    if (!this->extents_.empty()) {
+      Extent &last = this->extents_.back();
+      if (last.sector + last.count == (uint32_t) file.sect) {
+        last.count += count;
+        continue;
+      }
+    }
+    this->extents_.push_back(Extent{file_sector, (uint32_t) file.sect, count});
+  }
+  f_close(&file);
+  
+  ESP_LOGI(TAG, "%s: %u bytes in %u contiguous extents (cluster %u bytes)", fat_path, this->file_size_,
+           this->extents_.size(), cluster_sectors * this->sector_size_);
+  return !this->extents_.empty();
+}
+
+bool ExtentReader::read_sectors(uint32_t file_sector, uint32_t count, uint8_t *out) {
+  // Première plage contenant le secteur, puis les suivantes dans l'ordre
+  auto it = std::upper_bound(this->extents_.begin(), this->extents_.end(), file_sector,
+                             [](uint32_t sector, const Extent &extent) { return sector < extent.file_sector; });
+  if (it == this->extents_.begin()) {
+    return false;
+  }
+  --it;
+  while (count > 0) {
+    if (it == this->extents_.end()) {
+      return false;
+    }
+    const uint32_t skip = file_sector - it->file_sector;
+    const uint32_t chunk = std::min(count, it->count - skip);
+    if (disk_read(this->drive_, out, it->sector + skip, chunk) != RES_OK) {
+      ESP_LOGE(TAG, "disk_read failed at sector %u (%u sectors)", it->sector + skip, chunk);
+      return false;
+    }
+    out += chunk * this->sector_size_;
+    file_sector += chunk;
+    count -= chunk;
+    ++it;
+  }
+  return true;
+}
+
+FrameRef ExtentReader::read(uint32_t offset, uint32_t size, uint8_t *tail, uint32_t tail_size) {
+  if (size == 0 || (uint64_t) offset + size + tail_size > this->file_size_) {
+    return FrameRef();
+  }
+  // Lire des secteurs entiers dans le bloc ; le frame commence à `lead`
+  const uint32_t first = offset / this->sector_size_;
+  const uint32_t lead = offset % this->sector_size_;
+  const uint32_t count = (lead + size + tail_size + this->sector_size_ - 1) / this->sector_size_;
+  FrameRef frame = FrameRef::from_pool(count * this->sector_size_, lead, size);
+  if (!frame) {
+    return frame;
+  }
+  if (!this->read_sectors(first, count, frame.mutable_data() - lead)) {
+    return FrameRef();
+  }
+  if (tail_size > 0) {
+    memcpy(tail, frame.data() + size, tail_size);
+  }
+  return frame;
+}
+
+}  // namespace video_player
+}  // namespace esphome
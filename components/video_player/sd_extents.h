@@ -0,0 +1,54 @@
+#pragma once
+
+#include "frame_ref.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace esphome {
+namespace video_player {
+
+// Lecture directe d'un fichier FAT sur la carte SD, sans passer par le
+// système de fichiers à chaque frame. La chaîne de clusters est résolue une
+// seule fois à l'ouverture en une liste de plages de secteurs contiguës ;
+// chaque frame est ensuite lu en lectures multi-secteurs (disk_read)
+// directement dans son buffer.
+// Ne dépend que de FatFs (ff.h, diskio.h) : fonctionne aussi sur un hôte
+// avec une image FAT derrière disk_read. Le fichier ne doit pas être modifié
+// pendant la lecture (les plages ne seraient plus valides).
+class ExtentReader {
+ public:
+  // Chemin FatFs, avec le numéro de volume : "0:/video.mjpg"
+  bool open(const char *fat_path);
+  void close() { this->extents_.clear(); }
+  bool is_open() const { return !this->extents_.empty(); }
+
+  // Frame de `size` octets à la position `offset` du fichier, lu dans un bloc
+  // du pool arrondi aux secteurs (poignée vide en cas d'erreur). Les
+  // `tail_size` octets qui suivent (l'en-tête du frame suivant) sont lus dans
+  // la même requête et copiés dans `tail`.
+  FrameRef read(uint32_t offset, uint32_t size, uint8_t *tail = nullptr, uint32_t tail_size = 0);
+
+  size_t get_extent_count() const { return this->extents_.size(); }
+  uint32_t get_file_size() const { return this->file_size_; }
+
+ protected:
+  // Secteurs [sector, sector + count) de la carte = secteurs
+  // [file_sector, file_sector + count) du fichier
+  struct Extent {
+    uint32_t file_sector;
+    uint32_t sector;
+    uint32_t count;
+  };
+
+  bool read_sectors(uint32_t file_sector, uint32_t count, uint8_t *out);
+
+  std::vector<Extent> extents_;
+  uint8_t drive_{0};
+  uint32_t sector_size_{512};
+  uint32_t file_size_{0};
+};
+
+}  // namespace video_player
+}  // namespace esphome
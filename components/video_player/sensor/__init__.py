@@ -0,0 +1,27 @@
+"""Charge CPU mesurée par le gouverneur du lecteur vidéo."""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import STATE_CLASS_MEASUREMENT, UNIT_PERCENT
+
+from .. import CONF_VIDEO_PLAYER_ID, VideoPlayerComponent
+
+DEPENDENCIES = ["video_player"]
+
+CONFIG_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_PERCENT,
+    icon="mdi:cpu-64-bit",
+    accuracy_decimals=1,
+    state_class=STATE_CLASS_MEASUREMENT,
+).extend(
+    {
+        cv.GenerateID(CONF_VIDEO_PLAYER_ID): cv.use_id(VideoPlayerComponent),
+    }
+)
+
+
+async def to_code(config):
+    parent = await cg.get_variable(config[CONF_VIDEO_PLAYER_ID])
+    sens = await sensor.new_sensor(config)
+    cg.add(parent.set_cpu_load_sensor(sens))
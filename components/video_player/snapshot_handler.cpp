@@ -0,0 +1,48 @@
+#include "snapshot_handler.h"
+
+#ifdef USE_VIDEO_PLAYER_SNAPSHOT
+
+#include "video_player.h"
+#include "esphome/core/log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace esphome {
+namespace video_player {
+
+static const char *TAG = "video_snapshot";
+
+// Attente d'un frame quand aucun n'est retenu (premier client, ou après une
+// période sans demande)
+static const int SNAPSHOT_WAIT_ATTEMPTS = 10;
+
+bool SnapshotHandler::canHandle(AsyncWebServerRequest *request) {
+  return request->method() == HTTP_GET && request->url() == this->path_;
+}
+
+void SnapshotHandler::handleRequest(AsyncWebServerRequest *request) {
+  // Appelé depuis la tâche du serveur HTTP : le frame reste verrouillé
+  // pendant l'envoi (synchrone avec ESP-IDF), la boucle principale ne le
+  // remplace pas tant que l'envoi n'est pas terminé
+  const uint8_t *data;
+  size_t size;
+  for (int attempt = 0; !this->player_->lock_snapshot(&data, &size); attempt++) {
+    if (attempt == SNAPSHOT_WAIT_ATTEMPTS) {
+      ESP_LOGD(TAG, "No frame to serve");
+      request->send(503, "text/plain", "No frame presented yet");
+      return;
+    }
+    // La boucle principale retient le prochain frame présenté
+    vTaskDelay(pdMS_TO_TICKS(100));
+  }
+  AsyncWebServerResponse *response = request->beginResponse(200, "image/jpeg", data, size);
+  response->addHeader("Cache-Control", "no-store");
+  request->send(response);
+  this->player_->unlock_snapshot();
+}
+
+}  // namespace video_player
+}  // namespace esphome
+
+#endif  // USE_VIDEO_PLAYER_SNAPSHOT
@@ -0,0 +1,31 @@
+#pragma once
+
+#ifdef USE_VIDEO_PLAYER_SNAPSHOT
+
+#include "esphome/components/web_server_base/web_server_base.h"
+
+#include <string>
+
+namespace esphome {
+namespace video_player {
+
+class VideoPlayerComponent;
+
+// Point d'accès HTTP qui renvoie le JPEG du frame affiché tel qu'il a été lu :
+// ni décodage, ni ré-encodage, ni copie du frame.
+class SnapshotHandler : public AsyncWebHandler {
+ public:
+  SnapshotHandler(VideoPlayerComponent *player, const std::string &path) : player_(player), path_(path) {}
+
+  bool canHandle(AsyncWebServerRequest *request) override;
+  void handleRequest(AsyncWebServerRequest *request) override;
+
+ protected:
+  VideoPlayerComponent *player_;
+  std::string path_;
+};
+
+}  // namespace video_player
+}  // namespace esphome
+
+#endif  // USE_VIDEO_PLAYER_SNAPSHOT
@@ -0,0 +1,181 @@
+#include "video_engine.h"
+#include "video_player.h"
+#include "esphome/core/log.h"
+
+#include "esp_heap_caps.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace video_player {
+
+static const char *TAG = "video_engine";
+
+VideoEngine *VideoEngine::get() {
+  // Instance unique, créée au premier enregistrement d'un lecteur
+  static VideoEngine *instance = new VideoEngine();
+  return instance;
+}
+
+VideoEngine::VideoEngine() { this->pool_mutex_ = xSemaphoreCreateMutex(); }
+
+void VideoEngine::register_player(VideoPlayerComponent *player) {
+  if (std::find(this->players_.begin(), this->players_.end(), player) == this->players_.end()) {
+    this->players_.push_back(player);
+  }
+  ESP_LOGD(TAG, "Player registered (%d active)", this->players_.size());
+}
+
+void VideoEngine::unregister_player(VideoPlayerComponent *player) {
+  this->players_.erase(std::remove(this->players_.begin(), this->players_.end(), player), this->players_.end());
+}
+
+uint8_t *VideoEngine::acquire_buffer(size_t size) {
+  xSemaphoreTake(this->pool_mutex_, portMAX_DELAY);
+  uint8_t *data = this->acquire_block(size);
+  xSemaphoreGive(this->pool_mutex_);
+  return data;
+}
+
+uint8_t *VideoEngine::acquire_block(size_t size) {
+  // Réutiliser le plus petit bloc libre suffisamment grand
+  PoolBlock *best = nullptr;
+  for (auto &block : this->blocks_) {
+    if (!block.in_use && block.size >= size && (best == nullptr || block.size < best->size)) {
+      best = &block;
+    }
+  }
+  if (best != nullptr) {
+    best->in_use = true;
+    return best->data;
+  }
+
+  // Libérer des blocs inutilisés (trop petits) tant que le budget est dépassé
+  while (this->allocated_ + size > this->memory_budget_) {
+    if (!this->free_idle_block()) {
+      ESP_LOGW(TAG, "Memory budget exhausted (%u/%u bytes, requested %u)", this->allocated_, this->memory_budget_,
+               size);
+      return nullptr;
+    }
+  }
+
+  // Essayer d'abord avec la mémoire interne
+  uint8_t *data = (uint8_t *) heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if (!data) {
+    // Si ça échoue, essayer avec SPIRAM
+    data = (uint8_t *) heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!data) {
+      ESP_LOGE(TAG, "Failed to allocate pool block (requested %u bytes)", size);
+      return nullptr;
+    }
+  }
+
+  this->blocks_.push_back(PoolBlock{data, size, true});
+  this->allocated_ += size;
+  ESP_LOGD(TAG, "Pool block allocated: %u bytes (total %u/%u)", size, this->allocated_, this->memory_budget_);
+  return data;
+}
+
+void VideoEngine::release_buffer(uint8_t *buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+  xSemaphoreTake(this->pool_mutex_, portMAX_DELAY);
+  for (auto &block : this->blocks_) {
+    if (block.data == buffer) {
+      block.in_use = false;
+      xSemaphoreGive(this->pool_mutex_);
+      return;
+    }
+  }
+  xSemaphoreGive(this->pool_mutex_);
+  ESP_LOGW(TAG, "Released a buffer that does not belong to the pool");
+}
+
+bool VideoEngine::free_idle_block() {
+  // Libérer le plus petit bloc inutilisé : c'est le moins susceptible d'être réutilisé
+  auto victim = this->blocks_.end();
+  for (auto it = this->blocks_.begin(); it != this->blocks_.end(); ++it) {
+    if (!it->in_use && (victim == this->blocks_.end() || it->size < victim->size)) {
+      victim = it;
+    }
+  }
+  if (victim == this->blocks_.end()) {
+    return false;
+  }
+  heap_caps_free(victim->data);
+  this->allocated_ -= victim->size;
+  this->blocks_.erase(victim);
+  return true;
+}
+
+void VideoEngine::trim(size_t floor) {
+  for (auto *player : this->players_) {
+    if (player->is_playing()) {
+      return;  // Ses buffers seront réutilisés dès le prochain frame
+    }
+  }
+  // Libérer d'abord les plus gros blocs inutilisés
+  xSemaphoreTake(this->pool_mutex_, portMAX_DELAY);
+  while (this->allocated_ > floor) {
+    auto victim = this->blocks_.end();
+    for (auto it = this->blocks_.begin(); it != this->blocks_.end(); ++it) {
+      if (!it->in_use && (victim == this->blocks_.end() || it->size > victim->size)) {
+        victim = it;
+      }
+    }
+    if (victim == this->blocks_.end()) {
+      break;
+    }
+    heap_caps_free(victim->data);
+    this->allocated_ -= victim->size;
+    this->blocks_.erase(victim);
+  }
+  xSemaphoreGive(this->pool_mutex_);
+  ESP_LOGD(TAG, "Pool trimmed to %u bytes", this->allocated_);
+}
+
+bool VideoEngine::claim_slot(VideoPlayerComponent *player, uint32_t now) {
+  // Earliest deadline first : parmi les lecteurs arrivés à échéance,
+  // seul celui dont l'échéance est la plus ancienne décode à ce passage.
+  // L'appelant est considéré à échéance (sa présentation peut être pilotée
+  // par une horloge média plutôt que par son intervalle). Les autres ne
+  // comptent que s'ils attendent eux aussi un décodage : un lecteur retenu par
+  // l'horloge média ou en déplacement garde une échéance ancienne sans la
+  // réclamer, et bloquerait sinon tous les autres.
+  VideoPlayerComponent *earliest = nullptr;
+  int32_t earliest_lateness = 0;
+  for (auto *candidate : this->players_) {
+    if (!candidate->is_playing() || (candidate != player && !candidate->is_decode_ready())) {
+      continue;
+    }
+    int32_t lateness = (int32_t) (now - candidate->get_next_deadline());
+    if (candidate == player && lateness < 0) {
+      lateness = 0;
+    }
+    if (lateness < 0) {
+      continue;
+    }
+    if (earliest == nullptr || lateness > earliest_lateness) {
+      earliest = candidate;
+      earliest_lateness = lateness;
+    }
+  }
+  return earliest == player;
+}
+
+void VideoEngine::request_flush(display::Display *display) {
+  if (std::find(this->pending_flush_.begin(), this->pending_flush_.end(), display) == this->pending_flush_.end()) {
+    this->pending_flush_.push_back(display);
+  }
+}
+
+void VideoEngine::flush_pending() {
+  for (auto *display : this->pending_flush_) {
+    display->update();
+  }
+  this->pending_flush_.clear();
+}
+
+}  // namespace video_player
+}  // namespace esphome
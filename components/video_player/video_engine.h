@@ -0,0 +1,71 @@
+#pragma once
+
+#include "esphome/components/display/display.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace esphome {
+namespace video_player {
+
+class VideoPlayerComponent;
+
+// Moteur vidéo commun à toutes les instances de VideoPlayerComponent.
+// Il possède le pool de buffers (borné par un budget mémoire global) et
+// décide quel lecteur a le droit de décoder, par ordre d'échéance.
+class VideoEngine {
+ public:
+  static VideoEngine *get();
+
+  void register_player(VideoPlayerComponent *player);
+  void unregister_player(VideoPlayerComponent *player);
+
+  // Budget mémoire global du pool, tous lecteurs confondus
+  void set_memory_budget(size_t budget) { this->memory_budget_ = budget; }
+  size_t get_memory_budget() const { return this->memory_budget_; }
+  size_t get_allocated() const { return this->allocated_; }
+
+  // Emprunter / rendre un buffer du pool partagé (depuis n'importe quelle
+  // tâche : la dernière référence d'un frame peut tomber hors de loop())
+  uint8_t *acquire_buffer(size_t size);
+  void release_buffer(uint8_t *buffer);
+
+  // Rendre au système les blocs inutilisés au-delà de `floor` octets,
+  // seulement quand plus aucun lecteur ne joue
+  void trim(size_t floor);
+  
+  // Ordonnancement : vrai si ce lecteur est le plus en retard sur son échéance
+  bool claim_slot(VideoPlayerComponent *player, uint32_t now);
+
+  size_t get_player_count() const { return this->players_.size(); }
+
+  // Rafraîchissements regroupés : un seul update() par écran et par passage de loop()
+  void request_flush(display::Display *display);
+  void flush_pending();
+
+ protected:
+  VideoEngine();
+
+  struct PoolBlock {
+    uint8_t *data;
+    size_t size;
+    bool in_use;
+  };
+
+  uint8_t *acquire_block(size_t size);
+  bool free_idle_block();
+
+  std::vector<VideoPlayerComponent *> players_;
+  SemaphoreHandle_t pool_mutex_{nullptr};
+  std::vector<PoolBlock> blocks_;
+  std::vector<display::Display *> pending_flush_;
+  size_t memory_budget_{512 * 1024};
+  size_t allocated_{0};
+};
+
+}  // namespace video_player
+}  // namespace esphome
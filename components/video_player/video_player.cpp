@@ -1,6 +1,12 @@
 #include "esphome/core/log.h"
 #include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/preferences.h"
 #include "video_player.h"
+#include "video_engine.h"
+#include "snapshot_handler.h"
+#include "rans_decoder.h"
+#include "bandwidth_arbiter.h"
 
 // Inclusions pour ESP-IDF 5.1.5
 #include "esp_vfs.h"
@@ -20,22 +26,22 @@
 #include <functional>
 #include <memory>
 #include <algorithm>
+#include <math.h>
 
-// Ajout de l'inclusion pour jpg2rgb565
 #include "esp_jpg_decode.h"
 
-// Déclaration pour jpg2rgb565 si non déclaré ailleurs
-#ifndef jpg2rgb565
-extern "C" {
-  bool jpg2rgb565(const uint8_t *src, size_t src_len, uint8_t *out, jpg_scale_t scale);
-}
-#endif
-
 namespace esphome {
 namespace video_player {
 
 static const char *TAG = "video_player";
 
+// Nombre maximal de frames sautées d'un coup pour rattraper un retard
+static const uint32_t MAX_FRAME_DROP = 8;
+// Délai sans nouveau déplacement avant de décoder le frame visé en pleine qualité
+static const uint32_t SCRUB_REFINE_DELAY_MS = 250;
+// Fenêtre de mesure de la charge CPU du gouverneur
+static const int64_t CPU_WINDOW_US = 1000000;
+
 // Structure qui représente l'en-tête MJPEG
 typedef struct {
   uint32_t signature;    // Devrait être "MJPG"
@@ -51,10 +57,67 @@ typedef struct {
   uint32_t timestamp;    // Timestamp du frame en millisecondes
 } mjpeg_frame_header_t;
 
+// Bloc optionnel placé entre l'en-tête et le premier frame. Son identifiant
+// (quatre caractères ASCII) est toujours supérieur à la taille maximale d'un
+// frame, ce qui le distingue sans ambiguïté d'un en-tête de frame.
+typedef struct {
+  uint32_t fourcc;       // Type du bloc
+  uint32_t size;         // Taille des données du bloc en octets
+} mjpeg_chunk_header_t;
+
+// Taille maximale d'un frame JPEG
+static const uint32_t MAX_FRAME_SIZE = 1024 * 1024;
+
+// Index des frames persistant, rangé à côté de la vidéo ("<fichier>.idx")
+typedef struct {
+  uint32_t signature;    // "VIDX"
+  uint32_t version;
+  uint32_t file_size;    // Taille du fichier vidéo indexé
+  uint32_t data_offset;  // Position du premier frame
+  uint32_t video_frames; // Nombre de frames annoncé par l'en-tête vidéo
+  uint32_t fingerprint;  // Empreinte du contenu (voir compute_index_fingerprint)
+  uint32_t frame_count;  // Nombre d'entrées qui suivent
+} mjpeg_index_header_t;
+
+static const uint32_t INDEX_SIGNATURE = 0x58444956;  // "VIDX"
+static const uint32_t INDEX_VERSION = 2;
+// Octets lus au début du premier frame et en fin de fichier pour l'empreinte
+static const uint32_t INDEX_FINGERPRINT_SPAN = 512;
+
+// Temps accordé à la construction de l'index à chaque passage inactif de loop()
+static const int64_t INDEX_STEP_BUDGET_US = 1000;
+
+// "PSTR" : image d'attente pré-décodée (uint16 largeur, uint16 hauteur, pixels RGB565)
+static const uint32_t CHUNK_POSTER = 0x52545350;
+// Bloc "PLTE" : 256 couleurs RGB565 calculées par l'outil de conversion
+static const uint32_t CHUNK_PALETTE = 0x45544C50;
+// Bloc "ALPH" : chaque frame porte un masque alpha RLE après son JPEG
+// (uint8 profondeur : 1 ou 4 bits)
+static const uint32_t CHUNK_ALPHA = 0x48504C41;
+// Bloc "RANS" : les frames sont codés par rANS au lieu de JPEG (voir rans_decoder.h)
+static const uint32_t CHUNK_RANS = 0x534E4152;
+// Instantané gardé tant qu'un client l'a demandé depuis ce délai
+static const uint32_t SNAPSHOT_HOLD_MS = 10000;
+// Taille maximale d'un bloc lu en mémoire (PLTE, ALPH, RANS : quelques Ko)
+static const uint32_t MAX_CHUNK_PAYLOAD = 4096;
+// Table 3D de quantification : 4 bits par composante
+static const size_t PALETTE_LUT_SIZE = 16 * 16 * 16;
+// Lecture anticipée HTTP : au plus ce bloc par passage de loop(), selon les
+// jetons accordés par l'arbitre réseau
+static const size_t HTTP_PREFETCH_CHUNK = 16 * 1024;
+// Avance HTTP gardée en mémoire (fenêtre glissante dans le pool partagé),
+// agrandie pour un frame plus grand si le pool le permet
+static const size_t HTTP_LEAD_BUFFER = 128 * 1024;
+// Longueur d'un flux HTTP sans Content-Length : la fin de la connexion
+// marque la fin de la vidéo
+static const size_t HTTP_UNKNOWN_LENGTH = SIZE_MAX;
+// Réglage automatique : hauteurs de bande essayées, en lignes (chacune en
+// disposition linéaire puis en tuiles si le décodeur sait les écrire)
+static const uint16_t AUTOTUNE_BAND_HEIGHTS[] = {8, 16, 32, 64};
+static const int AUTOTUNE_BAND_COUNT = sizeof(AUTOTUNE_BAND_HEIGHTS) / sizeof(AUTOTUNE_BAND_HEIGHTS[0]);
+
 // Callback pour la lecture HTTP
 esp_err_t http_event_handler(esp_http_client_event_t *evt) {
-  VideoPlayerComponent* player = static_cast<VideoPlayerComponent*>(evt->user_data);
-  
   switch(evt->event_id) {
     case HTTP_EVENT_ON_DATA:
       ESP_LOGV(TAG, "HTTP_EVENT_ON_DATA, len=%d", evt->data_len);
@@ -72,15 +135,25 @@ esp_err_t http_event_handler(esp_http_client_event_t *evt) {
 }
 
 void VideoPlayerComponent::setup() {
+  this->setup_start_us_ = esp_timer_get_time();
+  
   if (this->display_ == nullptr) {
     ESP_LOGE(TAG, "Display not set!");
     this->mark_failed();
     return;
   }
   
+  // Zone d'affichage : l'écran entier ou une cellule de la mosaïque
+  this->update_viewport();
+  
   // Initialiser les mutex pour la synchronisation
   this->init_mutex();
   
+  // S'enregistrer auprès du moteur partagé (pool de buffers et ordonnancement)
+  VideoEngine::get()->register_player(this);
+  this->init_decoders();
+  this->autotune_pending_ = this->autotune_;
+  
   // Ne pas échouer immédiatement avec la source HTTP, nous réessaierons dans loop
   if (this->source_ == VideoSource::FILE) {
     if (!this->open_file_source()) {
@@ -89,37 +162,187 @@ void VideoPlayerComponent::setup() {
     }
     ESP_LOGI(TAG, "Video loaded: %dx%d, %d frames, %d FPS", 
              this->video_width_, this->video_height_, this->frame_count_, this->video_fps_);
+    
+    // Premiers pixels dès setup() : l'image d'attente si le conteneur en a une,
+    // sinon le premier frame décodé tout de suite plutôt qu'au premier loop()
+    this->prewarm();
+    if (this->show_poster() || this->present_next_frame()) {
+      this->schedule_flush();
+      this->mark_first_frame();
+      this->last_update_ = millis();
+    }
   } else if (this->source_ == VideoSource::HTTP) {
     // Juste journaliser que nous initialiserons plus tard
     ESP_LOGI(TAG, "HTTP source set, will initialize when network is available");
     this->http_initialized_ = false;
+    this->network_client_ = BandwidthArbiter::get()->register_client(this->network_name_, this->network_weight_,
+                                                                     this->network_max_rate_);
   }
   
   ESP_LOGI(TAG, "Display dimensions: %dx%d", display_->get_width(), display_->get_height());
 }
 
+void VideoPlayerComponent::set_mosaic(uint8_t columns, uint8_t rows, uint8_t cell) {
+  this->mosaic_columns_ = columns;
+  this->mosaic_rows_ = rows;
+  this->mosaic_cell_ = cell;
+}
+
+void VideoPlayerComponent::add_output(display::Display *display, uint16_t src_x, uint16_t src_y,
+                                      uint16_t src_width, uint16_t src_height) {
+  this->outputs_.push_back(VideoOutput{display, src_x, src_y, src_width, src_height});
+}
+
+void VideoPlayerComponent::schedule_flush() {
+  // Chaque écran ayant reçu des pixels est rafraîchi une fois, indépendamment des autres
+  if (this->outputs_.empty()) {
+    VideoEngine::get()->request_flush(this->display_);
+  }
+  for (auto &output : this->outputs_) {
+    VideoEngine::get()->request_flush(output.display);
+  }
+  this->defer("video_flush", []() { VideoEngine::get()->flush_pending(); });
+}
+
+void VideoPlayerComponent::update_viewport() {
+  const int display_width = this->display_->get_width();
+  const int display_height = this->display_->get_height();
+  
+  if (this->mosaic_columns_ == 0 || this->mosaic_rows_ == 0) {
+    this->viewport_x_ = 0;
+    this->viewport_y_ = 0;
+    this->viewport_width_ = display_width;
+    this->viewport_height_ = display_height;
+    return;
+  }
+  
+  const int cell_width = display_width / this->mosaic_columns_;
+  const int cell_height = display_height / this->mosaic_rows_;
+  this->viewport_x_ = (this->mosaic_cell_ % this->mosaic_columns_) * cell_width;
+  this->viewport_y_ = (this->mosaic_cell_ / this->mosaic_columns_) * cell_height;
+  this->viewport_width_ = cell_width;
+  this->viewport_height_ = cell_height;
+  ESP_LOGI(TAG, "Mosaic cell %d: %dx%d at (%d,%d)", this->mosaic_cell_, cell_width, cell_height,
+           this->viewport_x_, this->viewport_y_);
+}
+
 void VideoPlayerComponent::init_mutex() {
   // Initialiser les mutex pour la synchronisation
-  this->network_mutex_ = xSemaphoreCreateMutex();
-  if (this->network_mutex_ == nullptr) {
-    ESP_LOGE(TAG, "Failed to create network mutex");
-    this->mark_failed();
+#ifdef USE_VIDEO_PLAYER_SNAPSHOT
+  if (!this->snapshot_path_.empty()) {
+    this->snapshot_mutex_ = xSemaphoreCreateMutex();
+    if (this->snapshot_mutex_ == nullptr) {
+      ESP_LOGE(TAG, "Failed to create snapshot mutex");
+      return;
+    }
+    this->web_server_->add_handler(new SnapshotHandler(this, this->snapshot_path_));
+    ESP_LOGI(TAG, "Snapshot available at %s", this->snapshot_path_.c_str());
+  }
+#endif
+}
+
+void VideoPlayerComponent::publish_snapshot(const FrameRef &jpeg) {
+  // Personne ne regarde : ne pas retenir le bloc du frame dans le pool
+  if (this->snapshot_mutex_ == nullptr || this->last_snapshot_request_ == 0) {
+    return;
+  }
+  // Ne jamais attendre : si un envoi est en cours, l'instantané garde le frame
+  // précédent, toujours valide
+  if (xSemaphoreTake(this->snapshot_mutex_, 0) != pdTRUE) {
+    return;
+  }
+  FrameRef previous = std::move(this->snapshot_jpeg_);
+  this->snapshot_jpeg_ = jpeg;
+  this->snapshot_size_ = jpeg.size();
+  if (this->alpha_bits_ != 0 && jpeg.size() >= sizeof(uint32_t)) {
+    // Ne servir que le JPEG, sans le masque alpha qui le suit
+    uint32_t mask_size;
+    memcpy(&mask_size, jpeg.data() + jpeg.size() - sizeof(mask_size), sizeof(mask_size));
+    if (mask_size + sizeof(mask_size) <= jpeg.size()) {
+      this->snapshot_size_ = jpeg.size() - sizeof(mask_size) - mask_size;
+    }
+  }
+  xSemaphoreGive(this->snapshot_mutex_);
+  // previous est libéré ici, hors du mutex de l'instantané (le pool a son propre verrou)
+}
+
+void VideoPlayerComponent::service_snapshot(uint32_t now) {
+  if (this->snapshot_mutex_ == nullptr) {
+    return;
+  }
+  if (this->snapshot_requested_.exchange(false)) {
+    this->last_snapshot_request_ = now;
+    if (!this->snapshot_jpeg_ && this->presented_index_ >= 0 &&
+        (uint32_t) this->presented_index_ < this->frame_index_.size() && this->video_file_ != nullptr) {
+      // Demande après une période sans client (ou en pause) : relire le frame
+      // affiché, sans déplacer la lecture séquentielle
+      const long position = this->tell_file();
+      const uint32_t next_frame = this->next_frame_index_;
+      this->publish_snapshot(this->read_indexed_jpeg(this->presented_index_));
+      this->seek_file(position);
+      this->next_frame_index_ = next_frame;
+    }
     return;
   }
+  // Plus de demande depuis un moment : rendre le bloc au pool
+  if (this->last_snapshot_request_ != 0 && now - this->last_snapshot_request_ > SNAPSHOT_HOLD_MS &&
+      xSemaphoreTake(this->snapshot_mutex_, 0) == pdTRUE) {
+    FrameRef previous = std::move(this->snapshot_jpeg_);
+    this->last_snapshot_request_ = 0;
+    xSemaphoreGive(this->snapshot_mutex_);
+  }
+}
+
+bool VideoPlayerComponent::lock_snapshot(const uint8_t **data, size_t *size) {
+  this->snapshot_requested_ = true;
+  if (this->snapshot_mutex_ == nullptr || xSemaphoreTake(this->snapshot_mutex_, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return false;
+  }
+  if (!this->snapshot_jpeg_) {
+    xSemaphoreGive(this->snapshot_mutex_);
+    return false;
+  }
+  *data = this->snapshot_jpeg_.data();
+  *size = this->snapshot_size_;
+  return true;
 }
 
+void VideoPlayerComponent::unlock_snapshot() { xSemaphoreGive(this->snapshot_mutex_); }
+
 VideoPlayerComponent::~VideoPlayerComponent() {
   // Nettoyer les ressources
   this->cleanup();
 }
 
+void VideoPlayerComponent::set_memory_budget(size_t budget) {
+  // Le budget est global : il s'applique au pool partagé par tous les lecteurs
+  VideoEngine::get()->set_memory_budget(budget);
+}
+
+bool VideoPlayerComponent::is_playing() const {
+  if (this->is_failed() || this->paused_) {
+    return false;
+  }
+  if (this->source_ == VideoSource::FILE) {
+    return this->video_file_ != nullptr;
+  }
+  return this->http_initialized_;
+}
+
 void VideoPlayerComponent::cleanup() {
-  // Nettoyer les ressources HTTP
-  if (this->http_buffer_ != nullptr) {
-    heap_caps_free(this->http_buffer_);
-    this->http_buffer_ = nullptr;
+  VideoEngine::get()->unregister_player(this);
+  this->clear_frame_cache();
+  this->last_frame_.reset();
+  this->transition_from_.reset();
+  
+  if (this->palette_lut_ != nullptr) {
+    heap_caps_free(this->palette_lut_);
+    this->palette_lut_ = nullptr;
   }
   
+  // Nettoyer les ressources HTTP
+  this->release_http_source();
+  
   // Fermer le fichier vidéo
   if (this->video_file_ != nullptr) {
     fclose(this->video_file_);
@@ -127,9 +350,11 @@ void VideoPlayerComponent::cleanup() {
   }
   
   // Libérer les mutex
-  if (this->network_mutex_ != nullptr) {
-    vSemaphoreDelete(this->network_mutex_);
-    this->network_mutex_ = nullptr;
+  if (this->snapshot_mutex_ != nullptr) {
+    // Attendre la fin d'un éventuel envoi avant de rendre le frame
+    xSemaphoreTake(this->snapshot_mutex_, portMAX_DELAY);
+    this->snapshot_jpeg_.reset();
+    xSemaphoreGive(this->snapshot_mutex_);
   }
   
   // Démonter SPIFFS si nécessaire
@@ -149,11 +374,15 @@ bool VideoPlayerComponent::open_file_source() {
   };
   
   esp_err_t ret = esp_vfs_spiffs_register(&conf);
-  if (ret != ESP_OK) {
+  if (ret == ESP_ERR_INVALID_STATE) {
+    // Déjà monté par un autre lecteur : ne pas le démonter à notre nettoyage
+    ESP_LOGD(TAG, "SPIFFS already mounted");
+  } else if (ret != ESP_OK) {
     ESP_LOGE(TAG, "Failed to mount SPIFFS (%s)", esp_err_to_name(ret));
     return false;
+  } else {
+    this->spiffs_mounted_ = true;
   }
-  this->spiffs_mounted_ = true;
   
   // Ouvrir le fichier vidéo
   FILE* video_file = fopen(this->video_path_, "rb");
@@ -183,6 +412,30 @@ bool VideoPlayerComponent::open_file_source() {
   this->frame_count_ = header.frame_count;
   this->video_fps_ = header.fps;
   this->video_file_ = video_file;
+  fseek(video_file, 0, SEEK_END);
+  this->file_size_ = ftell(video_file);
+  fseek(video_file, sizeof(mjpeg_header_t), SEEK_SET);
+  this->data_offset_ = sizeof(mjpeg_header_t);
+  if (!this->parse_chunks()) {
+    fclose(video_file);
+    this->video_file_ = nullptr;
+    return false;
+  }
+  
+  // Carte SD : résoudre une fois la chaîne de clusters, les frames seront lus
+  // sans passer par FatFs ni la VFS
+  if (this->fat_path_ != nullptr && this->extent_reader_ == nullptr) {
+    this->extent_reader_.reset(new ExtentReader());
+    if (!this->extent_reader_->open(this->fat_path_) ||
+        this->extent_reader_->get_file_size() != this->file_size_) {
+      ESP_LOGW(TAG, "Raw SD reads unavailable for %s, using the file system", this->fat_path_);
+      this->extent_reader_.reset();
+    }
+  }
+  
+  // Reprendre l'index d'un démarrage précédent, sinon le construire au fil de l'eau
+  this->index_scan_offset_ = this->data_offset_;
+  this->load_frame_index();
   
   // Calculer l'intervalle entre les frames basé sur le FPS
   if (this->update_interval_ == 0) {
@@ -192,6 +445,205 @@ bool VideoPlayerComponent::open_file_source() {
   return true;
 }
 
+bool VideoPlayerComponent::parse_chunks() {
+  // Parcourir les blocs optionnels jusqu'au premier en-tête de frame
+  mjpeg_chunk_header_t chunk;
+  while (fread(&chunk, 1, sizeof(chunk), this->video_file_) == sizeof(chunk)) {
+    if (chunk.fourcc <= MAX_FRAME_SIZE) {
+      break;  // C'est un en-tête de frame
+    }
+    const uint32_t payload = this->data_offset_ + sizeof(chunk);
+    // La taille vient du fichier : un bloc qui dépasse la fin est corrompu
+    if (chunk.size > this->file_size_ - payload) {
+      ESP_LOGE(TAG, "Chunk 0x%08X claims %u bytes, only %u left in the file", chunk.fourcc, chunk.size,
+               this->file_size_ - payload);
+      return false;
+    }
+    if (chunk.fourcc == CHUNK_POSTER) {
+      // Les pixels restent dans le fichier, lus à l'affichage
+      uint16_t dims[2];
+      if (chunk.size >= sizeof(dims) && fread(dims, 1, sizeof(dims), this->video_file_) == sizeof(dims) &&
+          chunk.size >= sizeof(dims) + (uint32_t) dims[0] * dims[1] * 2) {
+        this->poster_offset_ = payload + sizeof(dims);
+        this->poster_width_ = dims[0];
+        this->poster_height_ = dims[1];
+        ESP_LOGD(TAG, "Poster frame: %dx%d", dims[0], dims[1]);
+      }
+    } else if (chunk.fourcc == CHUNK_PALETTE || chunk.fourcc == CHUNK_ALPHA || chunk.fourcc == CHUNK_RANS) {
+      if (chunk.size > MAX_CHUNK_PAYLOAD) {
+        ESP_LOGE(TAG, "Chunk 0x%08X too large (%u bytes), ignored", chunk.fourcc, chunk.size);
+      } else {
+        std::vector<uint8_t> data(chunk.size);
+        if (fread(data.data(), 1, chunk.size, this->video_file_) == chunk.size) {
+          this->apply_chunk(chunk.fourcc, data.data(), data.size());
+        }
+      }
+    } else {
+      ESP_LOGD(TAG, "Skipping unknown chunk 0x%08X (%u bytes)", chunk.fourcc, chunk.size);
+    }
+    this->data_offset_ = payload + chunk.size;
+    fseek(this->video_file_, this->data_offset_, SEEK_SET);
+  }
+  clearerr(this->video_file_);
+  fseek(this->video_file_, this->data_offset_, SEEK_SET);
+  this->on_chunks_parsed();
+  return true;
+}
+
+void VideoPlayerComponent::apply_chunk(uint32_t fourcc, const uint8_t *data, size_t size) {
+  // Blocs lus en mémoire, communs aux sources fichier et HTTP
+  switch (fourcc) {
+    case CHUNK_PALETTE:
+      if (size >= sizeof(this->palette_)) {
+        memcpy(this->palette_, data, sizeof(this->palette_));
+        this->has_palette_ = true;
+        ESP_LOGD(TAG, "Palette found (256 colors)");
+      }
+      break;
+    case CHUNK_ALPHA:
+      if (size >= 1 && (data[0] == 1 || data[0] == 4)) {
+        this->alpha_bits_ = data[0];
+        ESP_LOGD(TAG, "Alpha mask: %d bits", data[0]);
+      }
+      break;
+    case CHUNK_RANS:
+      this->use_rans_codec(data, size);
+      break;
+    default:
+      break;
+  }
+}
+
+void VideoPlayerComponent::on_chunks_parsed() {
+  // Vidéo JPEG sans décodeur pour cette cible : rien ne pourra s'afficher
+  if (!this->rans_codec_ && this->decoders_.empty()) {
+    ESP_LOGE(TAG, "No JPEG decoder available on this target: provide set_hardware_decoder() or use a rANS video");
+  }
+  if (this->palette_mode_) {
+    if (!this->has_palette_) {
+      ESP_LOGW(TAG, "Palette mode requested but the video has no palette, using RGB565");
+    } else {
+      this->build_palette_lut();
+    }
+  }
+}
+
+bool VideoPlayerComponent::build_palette_lut() {
+  if (this->palette_lut_ == nullptr) {
+    // Essayer d'abord avec la mémoire interne : la table est lue pour chaque pixel
+    this->palette_lut_ = (uint8_t *) heap_caps_malloc(PALETTE_LUT_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!this->palette_lut_) {
+      this->palette_lut_ = (uint8_t *) heap_caps_malloc(PALETTE_LUT_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+      if (!this->palette_lut_) {
+        ESP_LOGE(TAG, "Failed to allocate palette lookup table");
+        return false;
+      }
+    }
+  }
+  
+  // Pour chaque cellule de la table, la couleur de la palette la plus proche
+  // du centre de la cellule (distance pondérée selon la sensibilité de l'œil)
+  const int64_t start = esp_timer_get_time();
+  for (int r = 0; r < 16; r++) {
+    for (int g = 0; g < 16; g++) {
+      for (int b = 0; b < 16; b++) {
+        const int cr = (r << 4) | 8, cg = (g << 4) | 8, cb = (b << 4) | 8;
+        uint32_t best_distance = UINT32_MAX;
+        uint8_t best = 0;
+        for (int i = 0; i < 256; i++) {
+          const uint16_t c = this->palette_[i];
+          const int dr = (int) ((c >> 8) & 0xF8) - cr;
+          const int dg = (int) ((c >> 3) & 0xFC) - cg;
+          const int db = (int) ((c << 3) & 0xF8) - cb;
+          const uint32_t distance = 2 * dr * dr + 4 * dg * dg + 3 * db * db;
+          if (distance < best_distance) {
+            best_distance = distance;
+            best = i;
+          }
+        }
+        this->palette_lut_[(r << 8) | (g << 4) | b] = best;
+      }
+    }
+  }
+  // La palette d'affichage sera recalculée avec les réglages d'image courants
+  this->color_lut_dirty_ = true;
+  ESP_LOGI(TAG, "Palette mode enabled (lookup table built in %lld us)",
+           (long long) (esp_timer_get_time() - start));
+  return true;
+}
+
+FrameRef VideoPlayerComponent::quantize_frame(const FrameRef &rgb) {
+  // Frame compact en 8 bits : le buffer RGB565 retourne au pool avec sa dernière référence
+  const size_t count = (size_t) rgb.info().width * rgb.info().height;
+  FrameRef indexed = FrameRef::from_pool(count);
+  if (!indexed) {
+    return indexed;
+  }
+  const uint16_t *src = (const uint16_t *) rgb.data();
+  uint8_t *dst = indexed.mutable_data();
+  for (size_t i = 0; i < count; i++) {
+    const uint16_t p = src[i];
+    dst[i] = this->palette_lut_[((p >> 4) & 0xF00) | ((p >> 3) & 0xF0) | ((p >> 1) & 0xF)];
+  }
+  indexed.info() = rgb.info();
+  indexed.info().format = PixelFormat::INDEXED8;
+  indexed.attach(rgb.attached());
+  return indexed;
+}
+
+bool VideoPlayerComponent::show_poster() {
+  if (this->poster_offset_ == 0) {
+    return false;
+  }
+  
+  // Pixels déjà au format de l'écran : ni lecture de JPEG ni décodage
+  const size_t poster_size = (size_t) this->poster_width_ * this->poster_height_ * 2;
+  uint8_t *poster = VideoEngine::get()->acquire_buffer(poster_size);
+  if (poster == nullptr) {
+    return false;
+  }
+  bool result = fseek(this->video_file_, this->poster_offset_, SEEK_SET) == 0 &&
+                fread(poster, 1, poster_size, this->video_file_) == poster_size;
+  if (result) {
+    result = this->blit_frame(poster, this->poster_width_, this->poster_height_);
+  }
+  VideoEngine::get()->release_buffer(poster);
+  this->rewind();
+  return result;
+}
+
+void VideoPlayerComponent::prewarm() {
+  // Réserver dans le pool les buffers du prochain frame pour que le prochain
+  // passage de loop() n'ait aucune allocation à faire (démarrage et reprise)
+  const jpg_scale_t scale = this->select_scale();
+  const size_t rgb_size = (size_t) (this->video_width_ >> scale) * (this->video_height_ >> scale) * 2;
+  const size_t band_size = (size_t) this->viewport_width_ * std::min<uint32_t>(this->band_height_, this->viewport_height_) * 2;
+  
+  size_t jpeg_size = 0;
+  mjpeg_frame_header_t frame_header;
+  this->sync_file_position();
+  const long position = ftell(this->video_file_);
+  if (fread(&frame_header, 1, sizeof(frame_header), this->video_file_) == sizeof(frame_header) &&
+      frame_header.size <= MAX_FRAME_SIZE) {
+    jpeg_size = frame_header.size;
+  }
+  fseek(this->video_file_, position, SEEK_SET);
+  
+  uint8_t *rgb = VideoEngine::get()->acquire_buffer(rgb_size);
+  uint8_t *band = VideoEngine::get()->acquire_buffer(band_size);
+  uint8_t *jpeg = jpeg_size > 0 ? VideoEngine::get()->acquire_buffer(jpeg_size) : nullptr;
+  VideoEngine::get()->release_buffer(rgb);
+  VideoEngine::get()->release_buffer(band);
+  VideoEngine::get()->release_buffer(jpeg);
+}
+
+void VideoPlayerComponent::mark_first_frame() {
+  if (this->time_to_first_frame_us_ == 0) {
+    this->time_to_first_frame_us_ = esp_timer_get_time() - this->setup_start_us_;
+    ESP_LOGI(TAG, "Time to first frame: %u ms", (uint32_t) (this->time_to_first_frame_us_ / 1000));
+  }
+}
+
 bool VideoPlayerComponent::open_http_source() {
   if (this->http_url_ == nullptr) {
     ESP_LOGE(TAG, "HTTP URL not set!");
@@ -211,32 +663,8 @@ bool VideoPlayerComponent::open_http_source() {
     return false;
   }
 
-  // Ajouter une vérification d'activité WebDAV
-  bool webdav_active = false;  // Remplacer par une vérification réelle si possible
-  if (webdav_active) {
-    ESP_LOGW(TAG, "WebDAV transfer in progress, deferring video initialization");
-    return false;
-  }
-  
-  // Acquérir le mutex réseau avec un pattern RAII
-  bool mutex_acquired = false;
-  if (xSemaphoreTake(this->network_mutex_, pdMS_TO_TICKS(1000)) == pdTRUE) {
-    mutex_acquired = true;
-  } else {
-    ESP_LOGE(TAG, "Failed to acquire network mutex");
-    return false;
-  }
-  
-  // Créer un gestionnaire de nettoyage pour s'assurer que le mutex est libéré
-  auto mutex_guard = std::unique_ptr<bool, std::function<void(bool*)>>(
-    &mutex_acquired,
-    [this](bool* acquired) {
-      if (*acquired) {
-        xSemaphoreGive(this->network_mutex_);
-      }
-    }
-  );
-  
+  // Les autres transferts (WebDAV, OTA...) ne bloquent plus l'ouverture :
+  // l'arbitre réseau règle ensuite le débit de la lecture anticipée
   ESP_LOGI(TAG, "Connecting to HTTP source: %s", this->http_url_);
 
   // Afficher l'état du réseau
@@ -298,39 +726,22 @@ bool VideoPlayerComponent::open_http_source() {
     return false;
   }
   
+  // La taille annoncée dit si toute la vidéo tient dans l'avance en mémoire ;
+  // sans elle, la lecture se fait en flux dans l'avance, retéléchargée à
+  // chaque boucle
   if (content_length <= 0) {
     ESP_LOGW(TAG, "Content length unknown or zero, proceeding cautiously");
+  } else if (content_length <= (int) sizeof(mjpeg_header_t)) {
+    ESP_LOGE(TAG, "Content length too small (%d bytes)", content_length);
+    esp_http_client_close(client);
+    return false;
   }
-  
-  // Lire l'en-tête avec plus de diagnostics
-  size_t initial_buffer_size = 8192;
-  uint8_t* header_buffer = (uint8_t*)heap_caps_malloc(initial_buffer_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-  if (!header_buffer) {
-    ESP_LOGW(TAG, "Failed to allocate from internal memory, trying SPIRAM");
-    header_buffer = (uint8_t*)heap_caps_malloc(initial_buffer_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    if (!header_buffer) {
-      ESP_LOGE(TAG, "Failed to allocate HTTP buffer");
-      esp_http_client_close(client);
-      return false;
-    }
-  }
-  
-  // RAII pour le buffer
-  auto buffer_guard = std::unique_ptr<uint8_t, std::function<void(uint8_t*)>>(
-    header_buffer,
-    [](uint8_t* ptr) {
-      if (ptr != nullptr) {
-        heap_caps_free(ptr);
-      }
-    }
-  );
-  
-  // Timeout et diagnostic améliorés pour la lecture
-  const int read_timeout_ms = 5000;
-  int64_t start_time = esp_timer_get_time();
+  const size_t stream_length = content_length > 0 ? (size_t) content_length : HTTP_UNKNOWN_LENGTH;
   
   // Lire l'en-tête MJPEG avec plus de diagnostics
-  int read_len = esp_http_client_read(client, (char*)header_buffer, sizeof(mjpeg_header_t));
+  mjpeg_header_t header_data;
+  uint8_t *header_bytes = (uint8_t *) &header_data;
+  int read_len = esp_http_client_read(client, (char *) header_bytes, sizeof(mjpeg_header_t));
   if (read_len != sizeof(mjpeg_header_t)) {
     ESP_LOGE(TAG, "Failed to read MJPEG header from HTTP (got %d bytes, expected %d)",
              read_len, sizeof(mjpeg_header_t));
@@ -340,12 +751,12 @@ bool VideoPlayerComponent::open_http_source() {
       char hex_dump[100] = {0};
       char *ptr = hex_dump;
       for (int i = 0; i < std::min(read_len, 16); i++) {
-        ptr += sprintf(ptr, "%02X ", header_buffer[i]);
+        ptr += sprintf(ptr, "%02X ", header_bytes[i]);
       }
       ESP_LOGE(TAG, "First bytes: %s", hex_dump);
       
       // Vérifier si c'est potentiellement un JPEG standard
-      if (read_len >= 2 && header_buffer[0] == 0xFF && header_buffer[1] == 0xD8) {
+      if (read_len >= 2 && header_bytes[0] == 0xFF && header_bytes[1] == 0xD8) {
         ESP_LOGW(TAG, "Detected standard JPEG data instead of MJPEG container");
       }
     }
@@ -358,7 +769,7 @@ bool VideoPlayerComponent::open_http_source() {
   esp_task_wdt_reset();
   
   // Analyser l'en-tête avec plus de tolérance
-  mjpeg_header_t* header = (mjpeg_header_t*)header_buffer;
+  mjpeg_header_t* header = &header_data;
   ESP_LOGI(TAG, "Signature reçue: 0x%08X (attendue: 0x47504A4D)", header->signature);
   
   // Signature MJPEG alternative possible
@@ -390,9 +801,223 @@ bool VideoPlayerComponent::open_http_source() {
   this->video_height_ = header->height;
   this->frame_count_ = header->frame_count;
   this->video_fps_ = header->fps;
+  this->data_offset_ = sizeof(mjpeg_header_t);
+  
+  // Blocs optionnels (image d'attente, palette, masque, tables rANS) avant le
+  // premier frame : sans eux, ils seraient lus comme des frames
+  mjpeg_frame_header_t first_frame;
+  size_t first_frame_size = 0;
+  if (!this->parse_http_chunks(client, stream_length, (uint8_t *) &first_frame, &first_frame_size) ||
+      first_frame_size == 0) {
+    ESP_LOGE(TAG, "No frame in HTTP stream");
+    esp_http_client_close(client);
+    return false;
+  }
   
   ESP_LOGI(TAG, "Video parameters: %dx%d, %d frames, %d FPS", 
            this->video_width_, this->video_height_, this->frame_count_, this->video_fps_);
+  
+  // Fenêtre glissante du flux, rechargée au fil de loop() par http_prefetch() :
+  // la vidéo entière si elle tient dans l'avance, sinon HTTP_LEAD_BUFFER
+  this->http_content_length_ = stream_length;
+  const size_t capacity = std::min<size_t>(stream_length - this->data_offset_, HTTP_LEAD_BUFFER);
+  this->release_http_source();
+  this->http_buffer_ = VideoEngine::get()->acquire_buffer(capacity);
+  if (this->http_buffer_ == nullptr) {
+    ESP_LOGE(TAG, "Failed to allocate HTTP lead buffer (%u bytes)", capacity);
+    esp_http_client_close(client);
+    return false;
+  }
+  this->http_buffer_size_ = capacity;
+  this->http_buffer_size_used_ = 0;
+  this->http_buffer_pos_ = 0;
+  this->http_stream_offset_ = this->data_offset_;
+  this->http_discard_ = 0;
+  memcpy(this->http_buffer_, &first_frame, first_frame_size);
+  this->http_buffer_size_used_ = first_frame_size;
+  
+  // La connexion reste ouverte pour la suite du téléchargement
+  this->http_client_ = client;
+  client = NULL;
+  return true;
+}
+
+static int http_read_fully(esp_http_client_handle_t client, uint8_t *data, int size) {
+  // esp_http_client_read() peut rendre moins que demandé
+  int done = 0;
+  while (done < size) {
+    const int read_len = esp_http_client_read(client, (char *) data + done, size - done);
+    if (read_len <= 0) {
+      break;
+    }
+    done += read_len;
+  }
+  return done;
+}
+
+bool VideoPlayerComponent::parse_http_chunks(esp_http_client_handle_t client, size_t content_length,
+                                             uint8_t *frame_header, size_t *header_size) {
+  // Même parcours que parse_chunks(), mais le flux ne se relit pas : les blocs
+  // utiles sont lus en mémoire, les autres (image d'attente comprise) sautés
+  *header_size = 0;
+  mjpeg_chunk_header_t chunk;
+  while (this->data_offset_ + sizeof(chunk) <= content_length) {
+    if (http_read_fully(client, (uint8_t *) &chunk, sizeof(chunk)) != sizeof(chunk)) {
+      ESP_LOGE(TAG, "HTTP stream ended inside the chunk list");
+      return false;
+    }
+    if (chunk.fourcc <= MAX_FRAME_SIZE) {
+      // C'est un en-tête de frame : il ira au début de la fenêtre
+      memcpy(frame_header, &chunk, sizeof(chunk));
+      *header_size = sizeof(chunk);
+      break;
+    }
+    const size_t payload = this->data_offset_ + sizeof(chunk);
+    if (chunk.size > content_length - payload) {
+      ESP_LOGE(TAG, "Chunk 0x%08X claims %u bytes, only %u left in the stream", chunk.fourcc, chunk.size,
+               content_length - payload);
+      return false;
+    }
+    const bool in_memory = chunk.fourcc == CHUNK_PALETTE || chunk.fourcc == CHUNK_ALPHA || chunk.fourcc == CHUNK_RANS;
+    if (in_memory && chunk.size <= MAX_CHUNK_PAYLOAD) {
+      std::vector<uint8_t> data(chunk.size);
+      if (http_read_fully(client, data.data(), chunk.size) != (int) chunk.size) {
+        ESP_LOGE(TAG, "HTTP stream ended inside chunk 0x%08X", chunk.fourcc);
+        return false;
+      }
+      this->apply_chunk(chunk.fourcc, data.data(), data.size());
+    } else {
+      if (in_memory) {
+        ESP_LOGE(TAG, "Chunk 0x%08X too large (%u bytes), ignored", chunk.fourcc, chunk.size);
+      } else {
+        ESP_LOGD(TAG, "Skipping chunk 0x%08X (%u bytes)", chunk.fourcc, chunk.size);
+      }
+      uint8_t scratch[256];
+      for (uint32_t left = chunk.size; left > 0;) {
+        const int step = std::min<uint32_t>(left, sizeof(scratch));
+        if (http_read_fully(client, scratch, step) != step) {
+          ESP_LOGE(TAG, "HTTP stream ended inside chunk 0x%08X", chunk.fourcc);
+          return false;
+        }
+        left -= step;
+        esp_task_wdt_reset();
+      }
+    }
+    this->data_offset_ = payload + chunk.size;
+  }
+  this->on_chunks_parsed();
+  return true;
+}
+
+void VideoPlayerComponent::http_prefetch() {
+  if (this->http_client_ == nullptr) {
+    return;
+  }
+  
+  // Faire glisser la fenêtre : les frames déjà lus sortent du buffer. Une
+  // vidéo qui tient entière dans le buffer n'est jamais compactée, la boucle
+  // se fait alors en mémoire.
+  if (this->http_buffer_size_ - this->http_buffer_size_used_ < HTTP_PREFETCH_CHUNK && this->http_buffer_pos_ > 0 &&
+      this->http_content_length_ - this->data_offset_ > this->http_buffer_size_) {
+    memmove(this->http_buffer_, this->http_buffer_ + this->http_buffer_pos_,
+            this->http_buffer_size_used_ - this->http_buffer_pos_);
+    this->http_stream_offset_ += this->http_buffer_pos_;
+    this->http_buffer_size_used_ -= this->http_buffer_pos_;
+    this->http_buffer_pos_ = 0;
+  }
+  
+  // Seau vide : un autre transfert a la priorité, la vidéo joue sur son avance
+  const size_t wanted = std::min(this->http_buffer_size_ - this->http_buffer_size_used_, HTTP_PREFETCH_CHUNK);
+  if (wanted == 0) {
+    return;
+  }
+  const size_t granted = BandwidthArbiter::get()->acquire(this->network_client_, wanted);
+  if (granted == 0) {
+    return;
+  }
+  
+  esp_task_wdt_reset();
+  uint8_t *dest = this->http_buffer_ + this->http_buffer_size_used_;
+  int read_len = esp_http_client_read(this->http_client_, (char *) dest, granted);
+  if (read_len <= 0) {
+    // Fin d'un flux de longueur inconnue, ou connexion perdue : la lecture
+    // continue sur la partie reçue
+    if (this->http_content_length_ == HTTP_UNKNOWN_LENGTH && read_len == 0) {
+      ESP_LOGI(TAG, "HTTP download complete (%u bytes)", this->http_stream_offset_ + this->http_buffer_size_used_);
+    } else {
+      ESP_LOGW(TAG, "HTTP download stopped at %u/%u bytes", this->http_stream_offset_ + this->http_buffer_size_used_,
+               this->http_content_length_);
+    }
+    BandwidthArbiter::get()->release(this->network_client_, granted);
+    this->http_content_length_ = this->http_stream_offset_ + this->http_buffer_size_used_;
+    this->close_http_client();
+    return;
+  }
+  BandwidthArbiter::get()->release(this->network_client_, granted - read_len);
+  
+  // Jeter ce qui reste d'un frame trop grand pour le buffer
+  size_t received = read_len;
+  if (this->http_discard_ > 0) {
+    const size_t dropped = std::min(this->http_discard_, received);
+    memmove(dest, dest + dropped, received - dropped);
+    this->http_discard_ -= dropped;
+    this->http_stream_offset_ += dropped;
+    received -= dropped;
+  }
+  this->http_buffer_size_used_ += received;
+  
+  if (this->http_stream_offset_ + this->http_buffer_size_used_ >= this->http_content_length_) {
+    ESP_LOGI(TAG, "HTTP download complete (%u bytes)", this->http_content_length_);
+    this->close_http_client();
+  }
+}
+
+void VideoPlayerComponent::close_http_client() {
+  if (this->http_client_ != nullptr) {
+    esp_http_client_close(this->http_client_);
+    esp_http_client_cleanup(this->http_client_);
+    this->http_client_ = nullptr;
+  }
+}
+
+void VideoPlayerComponent::release_http_source() {
+  // Fermer la connexion et rendre la fenêtre au pool
+  this->close_http_client();
+  VideoEngine::get()->release_buffer(this->http_buffer_);
+  this->http_buffer_ = nullptr;
+  this->http_buffer_size_ = 0;
+  this->http_buffer_size_used_ = 0;
+  this->http_buffer_pos_ = 0;
+}
+
+bool VideoPlayerComponent::grow_http_buffer(size_t capacity) {
+  // Frame plus grand que l'avance : nouvelle fenêtre plus grande, la partie
+  // non lue passe au début
+  uint8_t *buffer = VideoEngine::get()->acquire_buffer(capacity);
+  if (buffer == nullptr) {
+    return false;
+  }
+  const size_t unread = this->http_buffer_size_used_ - this->http_buffer_pos_;
+  memcpy(buffer, this->http_buffer_ + this->http_buffer_pos_, unread);
+  VideoEngine::get()->release_buffer(this->http_buffer_);
+  ESP_LOGI(TAG, "HTTP lead buffer grown from %u to %u bytes", this->http_buffer_size_, capacity);
+  this->http_buffer_ = buffer;
+  this->http_buffer_size_ = capacity;
+  this->http_stream_offset_ += this->http_buffer_pos_;
+  this->http_buffer_size_used_ = unread;
+  this->http_buffer_pos_ = 0;
+  return true;
+}
+
+bool VideoPlayerComponent::http_frame_ready() const {
+  // Le prochain frame (en-tête et données) est-il entièrement reçu ?
+  if (this->http_buffer_ == nullptr ||
+      this->http_buffer_pos_ + sizeof(mjpeg_frame_header_t) > this->http_buffer_size_used_) {
+    return false;
+  }
+  mjpeg_frame_header_t frame_header;
+  memcpy(&frame_header, this->http_buffer_ + this->http_buffer_pos_, sizeof(frame_header));
+  return this->http_buffer_pos_ + sizeof(frame_header) + frame_header.size <= this->http_buffer_size_used_;
 }
 
 bool VideoPlayerComponent::read_next_frame() {
@@ -401,14 +1026,29 @@ bool VideoPlayerComponent::read_next_frame() {
       return false;
     }
     
-    // Lire l'en-tête du frame
+    // Lire l'en-tête du frame : déjà lu avec le frame précédent en lecture
+    // directe, sinon par le système de fichiers
+    long header_offset;
     mjpeg_frame_header_t frame_header;
-    size_t read_size = fread(&frame_header, 1, sizeof(frame_header), this->video_file_);
+    size_t read_size = sizeof(frame_header);
+    if (this->raw_reading_ && this->raw_header_valid_) {
+      header_offset = this->raw_position_;
+      memcpy(&frame_header, this->raw_next_header_, sizeof(frame_header));
+      this->raw_header_valid_ = false;
+    } else {
+      this->sync_file_position();
+      header_offset = ftell(this->video_file_);
+      read_size = fread(&frame_header, 1, sizeof(frame_header), this->video_file_);
+    }
     if (read_size != sizeof(frame_header)) {
       // Si on arrive à la fin du fichier, on boucle
       if (feof(this->video_file_)) {
+        if (!this->loop_video_) {
+          this->finish();
+          return false;
+        }
         ESP_LOGI(TAG, "End of video, restarting");
-        fseek(this->video_file_, sizeof(mjpeg_header_t), SEEK_SET);
+        this->rewind();
         return false;
       }
       ESP_LOGE(TAG, "Failed to read frame header");
@@ -420,200 +1060,1615 @@ bool VideoPlayerComponent::read_next_frame() {
       ESP_LOGE(TAG, "Frame size too large: %u bytes", frame_header.size);
       return false;
     }
+    this->note_frame_position(header_offset, frame_header.size, frame_header.timestamp);
     
-    // Allouer un buffer pour les données JPEG
-    uint8_t* jpeg_data = nullptr;
-    
-    // Essayer d'abord avec la mémoire interne
-    jpeg_data = (uint8_t*)heap_caps_malloc(frame_header.size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-    if (!jpeg_data) {
-      // Si ça échoue, essayer avec SPIRAM
-      jpeg_data = (uint8_t*)heap_caps_malloc(frame_header.size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-      if (!jpeg_data) {
-        ESP_LOGE(TAG, "Failed to allocate memory for JPEG data");
-        return false;
-      }
-    }
-    
-    // Lire les données JPEG
-    read_size = fread(jpeg_data, 1, frame_header.size, this->video_file_);
-    if (read_size != frame_header.size) {
-      ESP_LOGE(TAG, "Failed to read JPEG data");
-      heap_caps_free(jpeg_data);
+    // Emprunter un buffer pour les données JPEG au pool partagé (rendu avec la dernière référence)
+    FrameRef jpeg = this->read_file_jpeg(header_offset + sizeof(frame_header), frame_header.size);
+    if (!jpeg) {
       return false;
     }
+    jpeg.info().index = this->next_frame_index_++;
+    jpeg.info().timestamp = frame_header.timestamp;
+    jpeg.info().flags = FRAME_ENCODED;
     
     ESP_LOGD(TAG, "Read frame: %d bytes", frame_header.size);
     
-    // Clear display
-    display_->fill(Color::BLACK);
-    
     // Traiter le frame
-    bool result = process_frame(jpeg_data, frame_header.size);
-    
-    // Libérer la mémoire
-    heap_caps_free(jpeg_data);
-    
-    return result;
+    return this->process_frame(jpeg);
   }
   else if (this->source_ == VideoSource::HTTP) {
     // Lire depuis le buffer HTTP
-    if (this->http_buffer_ == nullptr || 
-        this->http_buffer_pos_ + sizeof(mjpeg_frame_header_t) >= this->http_buffer_size_used_) {
-      ESP_LOGW(TAG, "HTTP buffer empty or insufficient data, pos=%d, size=%d", 
-               this->http_buffer_pos_, this->http_buffer_size_used_);
-      
-      // Si nous avons atteint la fin du buffer, recommencer depuis le début
-      if (this->loop_video_) {
-        ESP_LOGI(TAG, "End of HTTP buffer, restarting");
-        this->http_buffer_pos_ = sizeof(mjpeg_header_t);  // Sauter l'en-tête
-        
-        // Si nous sommes toujours à la fin, c'est qu'il n'y a pas assez de données
-        if (this->http_buffer_pos_ + sizeof(mjpeg_frame_header_t) >= this->http_buffer_size_used_) {
-          ESP_LOGE(TAG, "Not enough data in HTTP buffer");
-          return false;
-        }
-      } else {
+    if (this->http_buffer_ == nullptr) {
+      return false;
+    }
+    if (this->http_buffer_pos_ + sizeof(mjpeg_frame_header_t) <= this->http_buffer_size_used_) {
+      mjpeg_frame_header_t frame_header;
+      memcpy(&frame_header, this->http_buffer_ + this->http_buffer_pos_, sizeof(frame_header));
+      if (frame_header.size == 0 || frame_header.size > MAX_FRAME_SIZE) {
+        // Flux désynchronisé : reprendre depuis le début
+        ESP_LOGE(TAG, "Invalid frame size: %u bytes", frame_header.size);
+        this->release_http_source();
+        this->http_initialized_ = false;
+        return false;
+      }
+      const size_t frame_bytes = sizeof(frame_header) + frame_header.size;
+      if (frame_bytes > this->http_buffer_size_ && !this->grow_http_buffer(frame_bytes + HTTP_PREFETCH_CHUNK)) {
+        // Plus grand que l'avance et le pool ne peut pas l'agrandir : ce frame
+        // ne tiendra jamais, on le saute
+        ESP_LOGW(TAG, "HTTP frame of %u bytes exceeds the %u-byte lead buffer and the pool cannot grow it, skipped",
+                 frame_header.size, this->http_buffer_size_);
+        this->http_discard_ = this->http_buffer_pos_ + sizeof(frame_header) + frame_header.size -
+                              this->http_buffer_size_used_;
+        this->http_stream_offset_ += this->http_buffer_size_used_;
+        this->http_buffer_size_used_ = 0;
+        this->http_buffer_pos_ = 0;
+        this->next_frame_index_++;
         return false;
       }
     }
-    
-    // Réinitialiser le watchdog avant de traiter le frame
+    if (!this->http_frame_ready()) {
+      // Téléchargement en cours : attendre la suite plutôt que de boucler
+      if (this->http_client_ != nullptr) {
+        ESP_LOGV(TAG, "Buffering HTTP video, %u/%u bytes", this->http_stream_offset_ + this->http_buffer_size_used_,
+                 this->http_content_length_);
+        return false;
+      }
+      
+      // Si nous avons atteint la fin du flux, recommencer depuis le début
+      if (this->loop_video_) {
+        ESP_LOGI(TAG, "End of HTTP stream, restarting");
+        this->rewind();
+        return false;
+      }
+      this->finish();
+      return false;
+    }
+    
+    // Réinitialiser le watchdog avant de traiter le frame
     esp_task_wdt_reset();
     
     // Lire l'en-tête du frame
-    mjpeg_frame_header_t* frame_header = (mjpeg_frame_header_t*)(this->http_buffer_ + this->http_buffer_pos_);
-    this->http_buffer_pos_ += sizeof(mjpeg_frame_header_t);
+    mjpeg_frame_header_t frame_header;
+    memcpy(&frame_header, this->http_buffer_ + this->http_buffer_pos_, sizeof(frame_header));
+    this->http_buffer_pos_ += sizeof(frame_header);
     
-    // Vérifier la taille du frame
-    if (frame_header->size > 1024*1024 || frame_header->size == 0) {  // Limite à 1MB
-      ESP_LOGE(TAG, "Invalid frame size: %u bytes", frame_header->size);
+    // Copie dans le pool : la fenêtre glisse pendant que le frame est utilisé
+    FrameRef jpeg = FrameRef::from_pool(frame_header.size);
+    if (!jpeg) {
+      this->http_buffer_pos_ -= sizeof(frame_header);
       return false;
     }
+    memcpy(jpeg.mutable_data(), this->http_buffer_ + this->http_buffer_pos_, frame_header.size);
+    jpeg.info().index = this->next_frame_index_++;
+    jpeg.info().timestamp = frame_header.timestamp;
+    jpeg.info().flags = FRAME_ENCODED;
+    this->http_buffer_pos_ += frame_header.size;
+    
+    ESP_LOGD(TAG, "Read HTTP frame: %d bytes", frame_header.size);
     
-    if (this->http_buffer_pos_ + frame_header->size > this->http_buffer_size_used_) {
-      ESP_LOGE(TAG, "Insufficient data in HTTP buffer for frame");
+    // Traiter le frame
+    return this->process_frame(jpeg);
+  }
+  
+  return false;
+}
+
+bool VideoPlayerComponent::skip_frame() {
+  // Avancer d'un frame sans le décoder
+  if (this->source_ == VideoSource::FILE) {
+    if (!this->video_file_) {
       return false;
     }
     
-    // Pointer vers les données JPEG dans le buffer
-    uint8_t* jpeg_data = this->http_buffer_ + this->http_buffer_pos_;
-    this->http_buffer_pos_ += frame_header->size;
+    // Avec l'index, un seul saut direct vers l'en-tête du frame suivant
+    const uint32_t next = this->next_frame_index_ + 1;
+    if (next < this->frame_index_.size()) {
+      this->seek_file(this->frame_index_[next].offset - sizeof(mjpeg_frame_header_t));
+      this->next_frame_index_ = next;
+      return true;
+    }
     
-    ESP_LOGD(TAG, "Read HTTP frame: %d bytes", frame_header->size);
+    this->sync_file_position();
+    const long header_offset = ftell(this->video_file_);
+    mjpeg_frame_header_t frame_header;
+    if (fread(&frame_header, 1, sizeof(frame_header), this->video_file_) != sizeof(frame_header)) {
+      if (feof(this->video_file_)) {
+        this->rewind();
+      }
+      return false;
+    }
+    this->note_frame_position(header_offset, frame_header.size, frame_header.timestamp);
+    if (fseek(this->video_file_, frame_header.size, SEEK_CUR) != 0) {
+      return false;
+    }
+    this->next_frame_index_++;
+    return true;
+  }
+  else if (this->source_ == VideoSource::HTTP) {
+    if (!this->http_frame_ready()) {
+      return false;
+    }
+    
+    mjpeg_frame_header_t frame_header;
+    memcpy(&frame_header, this->http_buffer_ + this->http_buffer_pos_, sizeof(frame_header));
+    this->http_buffer_pos_ += sizeof(frame_header) + frame_header.size;
+    this->next_frame_index_++;
+    return true;
+  }
+  
+  return false;
+}
+
+void VideoPlayerComponent::rewind() {
+  if (this->source_ == VideoSource::FILE) {
+    if (this->video_file_) {
+      this->seek_file(this->data_offset_);
+    }
+  } else if (this->http_buffer_ != nullptr && this->http_stream_offset_ == this->data_offset_) {
+    // Le début du flux est encore dans la fenêtre
+    this->http_buffer_pos_ = 0;
+  } else {
+    // Le début est sorti de la fenêtre : retélécharger depuis le début
+    this->release_http_source();
+    this->http_initialized_ = false;
+    this->last_http_init_attempt_ = 0;
+  }
+  this->next_frame_index_ = 0;
+}
+
+bool VideoPlayerComponent::ensure_frame_index() {
+  if (this->index_complete_) {
+    return !this->frame_index_.empty();
+  }
+  
+  if (this->source_ == VideoSource::FILE) {
+    // Terminer d'un coup ce que la construction en arrière-plan n'a pas encore vu
+    this->index_step(0);
+    return !this->frame_index_.empty();
+  }
+  
+  // Source HTTP : seule une fenêtre du flux est en mémoire, pas d'accès
+  // aléatoire (ni index, ni déplacement, ni lecture inverse)
+  return false;
+}
+
+bool VideoPlayerComponent::index_step(int64_t budget_us) {
+  if (this->index_complete_) {
+    return true;
+  }
+  if (!this->video_file_) {
+    return false;
+  }
+  
+  // Suivre la chaîne des en-têtes de frames par petits sauts, dans la limite
+  // du temps accordé (0 = jusqu'au bout), sans perturber la lecture en cours
+  const int64_t start = esp_timer_get_time();
+  const long resume = ftell(this->video_file_);
+  bool complete = false;
+  fseek(this->video_file_, this->index_scan_offset_, SEEK_SET);
+  while (true) {
+    mjpeg_frame_header_t frame_header;
+    if (fread(&frame_header, 1, sizeof(frame_header), this->video_file_) != sizeof(frame_header)) {
+      complete = true;
+      break;
+    }
+    const uint32_t offset = this->index_scan_offset_ + sizeof(frame_header);
+    if (frame_header.size == 0 || frame_header.size > MAX_FRAME_SIZE || offset + frame_header.size > this->file_size_) {
+      complete = true;
+      break;
+    }
+    this->frame_index_.push_back(FrameIndexEntry{offset, frame_header.size, frame_header.timestamp});
+    this->index_scan_offset_ = offset + frame_header.size;
+    if (fseek(this->video_file_, this->index_scan_offset_, SEEK_SET) != 0) {
+      complete = true;
+      break;
+    }
+    if (budget_us > 0 && esp_timer_get_time() - start >= budget_us) {
+      break;
+    }
+  }
+  clearerr(this->video_file_);
+  fseek(this->video_file_, resume, SEEK_SET);
+  
+  if (complete) {
+    this->on_index_complete();
+    this->save_frame_index();
+  }
+  return complete;
+}
+
+void VideoPlayerComponent::note_frame_position(uint32_t header_offset, uint32_t size, uint32_t timestamp) {
+  // La lecture normale fait avancer l'index quand elle est à la frontière du parcours
+  if (this->index_complete_ || header_offset != this->index_scan_offset_ ||
+      this->next_frame_index_ != this->frame_index_.size()) {
+    return;
+  }
+  const uint32_t offset = header_offset + sizeof(mjpeg_frame_header_t);
+  this->frame_index_.push_back(FrameIndexEntry{offset, size, timestamp});
+  this->index_scan_offset_ = offset + size;
+}
+
+void VideoPlayerComponent::on_index_complete() {
+  this->index_complete_ = true;
+  if (this->playback_mode_ == PlaybackMode::REVERSE && !this->frame_index_.empty()) {
+    this->frame_position_ = this->frame_index_.size() - 1;
+  }
+  ESP_LOGI(TAG, "Frame index built: %u frames", this->frame_index_.size());
+}
+
+std::string VideoPlayerComponent::get_index_path() const {
+  // L'index est rangé à côté de la vidéo
+  return std::string(this->video_path_) + ".idx";
+}
+
+uint32_t VideoPlayerComponent::compute_index_fingerprint() {
+  // Une vidéo réencodée à la même taille garde rarement le même en-tête, le
+  // même début de premier frame et la même fin : FNV-1a sur ces trois zones
+  uint32_t hash = 2166136261UL;
+  if (!this->video_file_) {
+    return hash;
+  }
+  const long position = ftell(this->video_file_);
+  uint8_t buffer[INDEX_FINGERPRINT_SPAN];
+  const uint32_t spans[3][2] = {
+      {0, sizeof(mjpeg_header_t)},
+      {this->data_offset_, INDEX_FINGERPRINT_SPAN},
+      {this->file_size_ > INDEX_FINGERPRINT_SPAN ? this->file_size_ - INDEX_FINGERPRINT_SPAN : 0,
+       INDEX_FINGERPRINT_SPAN},
+  };
+  for (const auto &span : spans) {
+    size_t len = 0;
+    if (fseek(this->video_file_, span[0], SEEK_SET) == 0) {
+      len = fread(buffer, 1, span[1], this->video_file_);
+    }
+    for (size_t i = 0; i < len; i++) {
+      hash = (hash ^ buffer[i]) * 16777619UL;
+    }
+  }
+  fseek(this->video_file_, position, SEEK_SET);
+  return hash;
+}
+
+bool VideoPlayerComponent::load_frame_index() {
+  FILE *index_file = fopen(this->get_index_path().c_str(), "rb");
+  if (!index_file) {
+    return false;
+  }
+  
+  // Rejeter un index qui ne correspond plus au fichier vidéo
+  mjpeg_index_header_t header;
+  bool valid = fread(&header, 1, sizeof(header), index_file) == sizeof(header) &&
+               header.signature == INDEX_SIGNATURE && header.version == INDEX_VERSION &&
+               header.file_size == this->file_size_ && header.data_offset == this->data_offset_ &&
+               header.video_frames == this->frame_count_ && header.frame_count > 0 &&
+               header.frame_count <= this->file_size_ / sizeof(mjpeg_frame_header_t) &&
+               header.fingerprint == this->compute_index_fingerprint();
+  if (valid) {
+    this->frame_index_.resize(header.frame_count);
+    valid = fread(this->frame_index_.data(), sizeof(FrameIndexEntry), header.frame_count, index_file) ==
+            header.frame_count;
+  }
+  fclose(index_file);
+  
+  // Chaque entrée doit désigner un frame entier à l'intérieur du fichier
+  uint32_t previous_end = this->data_offset_;
+  for (size_t i = 0; valid && i < this->frame_index_.size(); i++) {
+    const FrameIndexEntry &entry = this->frame_index_[i];
+    valid = entry.offset >= previous_end + sizeof(mjpeg_frame_header_t) && entry.size > 0 &&
+            entry.size <= MAX_FRAME_SIZE && (uint64_t) entry.offset + entry.size <= this->file_size_;
+    previous_end = entry.offset + entry.size;
+  }
+  
+  if (!valid) {
+    ESP_LOGW(TAG, "Ignoring stale frame index %s", this->get_index_path().c_str());
+    this->frame_index_.clear();
+    return false;
+  }
+  ESP_LOGD(TAG, "Frame index loaded from %s", this->get_index_path().c_str());
+  this->on_index_complete();
+  return true;
+}
+
+void VideoPlayerComponent::save_frame_index() {
+  if (this->frame_index_.empty()) {
+    return;
+  }
+  const std::string path = this->get_index_path();
+  FILE *index_file = fopen(path.c_str(), "wb");
+  if (!index_file) {
+    ESP_LOGW(TAG, "Cannot write frame index %s", path.c_str());
+    return;
+  }
+  
+  mjpeg_index_header_t header = {INDEX_SIGNATURE, INDEX_VERSION, this->file_size_, this->data_offset_,
+                                 this->frame_count_, this->compute_index_fingerprint(),
+                                 (uint32_t) this->frame_index_.size()};
+  bool ok = fwrite(&header, 1, sizeof(header), index_file) == sizeof(header) &&
+            fwrite(this->frame_index_.data(), sizeof(FrameIndexEntry), this->frame_index_.size(), index_file) ==
+                this->frame_index_.size();
+  fclose(index_file);
+  if (!ok) {
+    ESP_LOGW(TAG, "Failed to write frame index %s", path.c_str());
+    remove(path.c_str());
+    return;
+  }
+  ESP_LOGI(TAG, "Frame index saved to %s", path.c_str());
+}
+
+bool VideoPlayerComponent::present_next_frame() {
+  if (this->playback_mode_ == PlaybackMode::FORWARD) {
+    return this->read_next_frame();
+  }
+  
+  // Lecture inversée ou aller-retour : accès direct par l'index
+  if (!this->ensure_frame_index()) {
+    return false;
+  }
+  bool result = this->present_indexed_frame(this->frame_position_);
+  this->frame_position_ = this->step_position();
+  return result;
+}
+
+uint32_t VideoPlayerComponent::step_position() {
+  const int32_t count = this->frame_index_.size();
+  int32_t next = (int32_t) this->frame_position_ + this->direction_;
+  if (next >= 0 && next < count) {
+    return next;
+  }
+  
+  if (this->playback_mode_ == PlaybackMode::PING_PONG && count > 1) {
+    // Demi-tour sans répéter le frame d'extrémité
+    this->direction_ = -this->direction_;
+    return this->frame_position_ + this->direction_;
+  }
+  // Lecture inversée : reprendre au dernier frame
+  return count - 1;
+}
+
+bool VideoPlayerComponent::present_indexed_frame(uint32_t index) {
+  if (index >= this->frame_index_.size()) {
+    return false;
+  }
+  
+  // Réutiliser le frame déjà décodé s'il est en cache : ni lecture ni décodage
+  CachedFrame *cached = this->find_cached_frame(index);
+  if (cached != nullptr) {
+    this->cache_hits_++;
+    this->presented_index_ = index;
+    return this->blit_frame(cached->frame);
+  }
+  
+  FrameRef jpeg = this->read_indexed_jpeg(index);
+  return jpeg && this->process_frame(jpeg);
+}
+
+static_assert(sizeof(mjpeg_frame_header_t) == 8, "raw_next_header_ holds one frame header");
+
+FrameRef VideoPlayerComponent::read_file_jpeg(uint32_t offset, uint32_t size) {
+  if (this->extent_reader_) {
+    // Lecture multi-secteurs directe dans le buffer du frame, avec l'en-tête
+    // du frame suivant ; le FILE n'est pas déplacé, seule la position logique
+    // avance
+    const uint32_t tail_size =
+        (uint64_t) offset + size + sizeof(this->raw_next_header_) <= this->file_size_ ? sizeof(this->raw_next_header_)
+                                                                                      : 0;
+    FrameRef jpeg = this->extent_reader_->read(offset, size, this->raw_next_header_, tail_size);
+    if (!jpeg) {
+      ESP_LOGE(TAG, "Failed to read JPEG data at %u (raw)", offset);
+      return jpeg;
+    }
+    this->raw_reading_ = true;
+    this->raw_position_ = offset + size;
+    this->raw_header_valid_ = tail_size > 0;
+    return jpeg;
+  }
+  
+  // Le fichier doit être positionné sur les données ; il est laissé juste après
+  
+  FrameRef jpeg = FrameRef::from_pool(size);
+  if (!jpeg) {
+    ESP_LOGE(TAG, "Failed to allocate memory for JPEG data");
+    return jpeg;
+  }
+  if (fread(jpeg.mutable_data(), 1, size, this->video_file_) != size) {
+    ESP_LOGE(TAG, "Failed to read JPEG data at %u", offset);
+    return FrameRef();
+  }
+  return jpeg;
+}
+
+long VideoPlayerComponent::tell_file() {
+  return this->raw_reading_ ? (long) this->raw_position_ : ftell(this->video_file_);
+}
+
+void VideoPlayerComponent::seek_file(long offset) {
+  // La position logique redevient celle du FILE
+  this->raw_reading_ = false;
+  this->raw_header_valid_ = false;
+  fseek(this->video_file_, offset, SEEK_SET);
+}
+
+void VideoPlayerComponent::sync_file_position() {
+  // Repli sur le système de fichiers : recaler le FILE sur la position logique
+  if (this->raw_reading_) {
+    this->seek_file(this->raw_position_);
+  }
+}
+
+FrameRef VideoPlayerComponent::read_indexed_jpeg(uint32_t index) {
+  const FrameIndexEntry &entry = this->frame_index_[index];
+  FrameRef jpeg;
+  // Accès direct en O(1) grâce à l'index (source fichier seulement) ; la
+  // lecture directe n'a pas besoin de déplacer le FILE
+  if (!this->video_file_ ||
+      (!this->extent_reader_ && fseek(this->video_file_, entry.offset, SEEK_SET) != 0)) {
+    return jpeg;
+  }
+  jpeg = this->read_file_jpeg(entry.offset, entry.size);
+  // La lecture séquentielle suit la position du fichier : juste après ce
+  // frame, ou sur son en-tête si la lecture a échoué
+  if (!jpeg) {
+    this->seek_file(entry.offset - sizeof(mjpeg_frame_header_t));
+    this->next_frame_index_ = index;
+    return jpeg;
+  }
+  this->next_frame_index_ = index + 1;
+  jpeg.info().index = index;
+  jpeg.info().timestamp = entry.timestamp;
+  jpeg.info().flags = FRAME_ENCODED;
+  return jpeg;
+}
+
+void VideoPlayerComponent::seek_position(uint32_t index) {
+  if (index >= this->frame_index_.size()) {
+    index = 0;
+  }
+  this->frame_position_ = index;
+  
+  // Repositionner aussi la lecture séquentielle sur l'en-tête de ce frame
+  const uint32_t header_offset = this->frame_index_[index].offset - sizeof(mjpeg_frame_header_t);
+  if (this->video_file_) {
+    this->seek_file(header_offset);
+  }
+  this->next_frame_index_ = index;
+}
+
+bool VideoPlayerComponent::scrub_to(uint32_t index) {
+  if (!this->ensure_frame_index() || index >= this->frame_index_.size()) {
+    return false;
+  }
+  
+  // Aperçu immédiat : décodage DC seulement (1/8), agrandi dans la zone d'affichage
+  FrameRef preview = this->decode_frame(this->read_indexed_jpeg(index), JPG_SCALE_8X);
+  if (!preview) {
+    return false;
+  }
+  bool result = this->blit_frame(preview);
+  
+  // La version pleine qualité sera décodée quand le déplacement s'arrête
+  this->scrubbing_ = true;
+  this->scrub_target_ = index;
+  this->last_scrub_ = millis();
+  this->schedule_flush();
+  return result;
+}
+
+bool VideoPlayerComponent::draw_thumbnail_strip(int x, int y, int width, int height, uint8_t count) {
+  if (count == 0 || !this->ensure_frame_index()) {
+    return false;
+  }
+  
+  // N frames régulièrement espacés, décodés en DC seulement comme l'aperçu de déplacement
+  const uint32_t frames = this->frame_index_.size();
+  const int thumb_width = width / count;
+  // Position de lecture gardée telle quelle : en fin de clip, next_frame vaut
+  // frames et seek_position() reviendrait au début
+  const uint32_t next_frame = this->next_frame_index_;
+  const uint32_t position = this->frame_position_;
+  const long read_position = this->video_file_ ? this->tell_file() : -1;
+  bool result = true;
+  for (uint8_t i = 0; i < count; i++) {
+    const uint32_t index = (uint32_t) i * frames / count;
+    FrameRef thumb = this->decode_frame(this->read_indexed_jpeg(index), JPG_SCALE_8X);
+    if (!thumb) {
+      result = false;
+      continue;
+    }
+    result &= this->blit_frame_to(thumb.data(), thumb.info().width, thumb.info().height,
+                                  x + i * thumb_width, y, thumb_width, height, thumb.info().format);
+    esp_task_wdt_reset();
+  }
+  
+  // Remettre la lecture là où elle en était
+  if (read_position >= 0) {
+    this->seek_file(read_position);
+  }
+  this->next_frame_index_ = next_frame;
+  this->frame_position_ = position;
+  
+  VideoEngine::get()->request_flush(this->display_);
+  this->defer("video_flush", []() { VideoEngine::get()->flush_pending(); });
+  return result;
+}
+
+CachedFrame *VideoPlayerComponent::find_cached_frame(uint32_t index) {
+  for (auto &frame : this->frame_cache_) {
+    if (frame.frame.info().index == index) {
+      frame.last_used = ++this->cache_clock_;
+      return &frame;
+    }
+  }
+  return nullptr;
+}
+
+void VideoPlayerComponent::cache_frame(const FrameRef &frame) {
+  // Évincer le frame le moins récemment utilisé si le cache est plein
+  if (this->frame_cache_.size() >= this->frame_cache_size_) {
+    auto victim = std::min_element(this->frame_cache_.begin(), this->frame_cache_.end(),
+                                   [](const CachedFrame &a, const CachedFrame &b) {
+                                     return a.last_used < b.last_used;
+                                   });
+    this->frame_cache_.erase(victim);
+  }
+  this->frame_cache_.push_back(CachedFrame{frame, ++this->cache_clock_});
+}
+
+void VideoPlayerComponent::clear_frame_cache() {
+  // Les blocs retournent au pool avec leur dernière référence
+  this->frame_cache_.clear();
+}
+
+bool VideoPlayerComponent::peek_frame_timestamp(uint32_t *timestamp) {
+  // Lire l'en-tête du prochain frame sans avancer
+  mjpeg_frame_header_t frame_header;
+  if (this->source_ == VideoSource::FILE) {
+    if (!this->video_file_) {
+      return false;
+    }
+    // En lecture directe, l'en-tête a déjà été lu avec le frame précédent
+    if (this->raw_reading_ && this->raw_header_valid_) {
+      memcpy(&frame_header, this->raw_next_header_, sizeof(frame_header));
+      *timestamp = frame_header.timestamp;
+      return true;
+    }
+    this->sync_file_position();
+    if (fread(&frame_header, 1, sizeof(frame_header), this->video_file_) != sizeof(frame_header)) {
+      if (!feof(this->video_file_)) {
+        return false;
+      }
+      // Fin du fichier : le prochain frame est le premier
+      this->rewind();
+      if (fread(&frame_header, 1, sizeof(frame_header), this->video_file_) != sizeof(frame_header)) {
+        return false;
+      }
+    }
+    fseek(this->video_file_, -(long) sizeof(frame_header), SEEK_CUR);
+  } else {
+    if (this->http_buffer_ == nullptr) {
+      return false;
+    }
+    if (this->http_buffer_pos_ + sizeof(mjpeg_frame_header_t) > this->http_buffer_size_used_) {
+      if (this->http_client_ != nullptr) {
+        return false;
+      }
+      this->rewind();
+      if (this->http_buffer_ == nullptr ||
+          this->http_buffer_pos_ + sizeof(mjpeg_frame_header_t) > this->http_buffer_size_used_) {
+        return false;
+      }
+    }
+    memcpy(&frame_header, this->http_buffer_ + this->http_buffer_pos_, sizeof(frame_header));
+  }
+  *timestamp = frame_header.timestamp;
+  return true;
+}
+
+bool VideoPlayerComponent::sync_frame_due() {
+  // Comparer le timestamp du prochain frame à l'horloge média partagée.
+  // En avance : on garde le frame affiché ; en retard : on saute sans décoder.
+  int64_t media_ms;
+  if (!this->clock_sync_->get_media_time_ms(&media_ms) || this->video_fps_ == 0 || this->frame_count_ == 0) {
+    return false;
+  }
+  const int32_t duration_ms = this->frame_count_ * 1000 / this->video_fps_;
+  const int32_t frame_ms = 1000 / this->video_fps_;
+  // Position dans la boucle calculée en 64 bits, réduite ensuite à la durée du clip
+  const int32_t target_ms = (int32_t) (media_ms % duration_ms);
+  
+  for (uint32_t dropped = 0; dropped <= MAX_FRAME_DROP; dropped++) {
+    uint32_t timestamp;
+    if (!this->peek_frame_timestamp(&timestamp)) {
+      return false;
+    }
     
-    // Clear display
-    display_->fill(Color::BLACK);
+    // Écart circulaire : la vidéo boucle sur elle-même
+    int32_t diff = (target_ms - (int32_t) timestamp) % duration_ms;
+    if (diff > duration_ms / 2) {
+      diff -= duration_ms;
+    } else if (diff < -duration_ms / 2) {
+      diff += duration_ms;
+    }
     
-    // Traiter le frame
-    return process_frame(jpeg_data, frame_header->size);
+    if (diff < 0) {
+      // Frame pas encore dû : on le garde pour plus tard
+      this->frames_held_++;
+      return false;
+    }
+    if (diff < frame_ms) {
+      return true;
+    }
+    if (!this->skip_frame()) {
+      return false;
+    }
+    this->frames_dropped_++;
+  }
+  
+  // Trop de retard pour un seul passage : présenter le frame courant
+  return true;
+}
+
+void VideoPlayerComponent::pause() {
+  if (this->paused_) {
+    return;
+  }
+  this->paused_ = true;
+  this->scrubbing_ = false;
+  
+  // Ne garder que le frame affiché, si demandé ; tout le reste retourne au pool
+  if (this->keep_last_frame_) {
+    this->retain_last_frame();
+  }
+  this->clear_frame_cache();
+  std::vector<uint16_t>().swap(this->x_map_);
+  this->x_map_src_width_ = 0;
+  
+  // Le pool partagé n'est réduit que si aucun autre lecteur ne joue
+  VideoEngine::get()->trim(this->idle_memory_floor_);
+  ESP_LOGI(TAG, "Playback paused (pool: %u bytes)", VideoEngine::get()->get_allocated());
+}
+
+void VideoPlayerComponent::resume() {
+  if (!this->paused_) {
+    return;
+  }
+  this->paused_ = false;
+  this->last_frame_.reset();
+  if (this->finished_) {
+    this->finished_ = false;
+    this->rewind();
+    this->frame_position_ = 0;
+  }
+  
+  // Réserver d'un coup les buffers du prochain frame
+  if (this->source_ == VideoSource::FILE && this->video_file_ != nullptr) {
+    this->prewarm();
+  }
+  // Prochain frame tout de suite, sans rattrapage ni dette CPU de la pause
+  this->last_update_ = 0;
+  this->cpu_window_start_us_ = 0;
+  this->cpu_busy_us_ = 0;
+  ESP_LOGI(TAG, "Playback resumed");
+}
+
+void VideoPlayerComponent::finish() {
+  // Fin de la vidéo sans boucle : même état de veille qu'une pause
+  ESP_LOGI(TAG, "End of video");
+  this->finished_ = true;
+  this->pause();
+}
+
+void VideoPlayerComponent::close_file_source() {
+  // Tout ce qui dépend du fichier ; les réglages du lecteur sont conservés
+  if (this->video_file_ != nullptr) {
+    fclose(this->video_file_);
+    this->video_file_ = nullptr;
+  }
+  this->extent_reader_.reset();
+  this->raw_reading_ = false;
+  this->raw_header_valid_ = false;
+  this->clear_frame_cache();
+  this->last_frame_.reset();
+  this->frame_index_.clear();
+  this->index_complete_ = false;
+  this->next_frame_index_ = 0;
+  this->frame_position_ = 0;
+  this->direction_ = 1;
+  this->presented_index_ = -1;
+  this->scrubbing_ = false;
+  this->poster_offset_ = 0;
+  this->has_palette_ = false;
+  this->alpha_bits_ = 0;
+  if (this->rans_codec_) {
+    // Le clip suivant est peut-être en JPEG
+    this->rans_codec_ = false;
+    this->init_decoders();
+  }
+}
+
+FrameRef VideoPlayerComponent::capture_outgoing_frame() {
+  // Le frame affiché, au format RGB565 : la palette de l'ancien clip
+  // disparaît avec lui
+  if (this->last_frame_ && this->last_frame_.info().format != PixelFormat::INDEXED8) {
+    return this->last_frame_;
+  }
+  if (this->presented_index_ < 0) {
+    return FrameRef();
+  }
+  const uint32_t index = this->presented_index_;
+  CachedFrame *cached = this->find_cached_frame(index);
+  if (cached != nullptr && cached->frame.info().format != PixelFormat::INDEXED8) {
+    return cached->frame;
+  }
+  if (index >= this->frame_index_.size()) {
+    return FrameRef();
+  }
+  return this->decode_frame(this->read_indexed_jpeg(index), this->select_scale());
+}
+
+bool VideoPlayerComponent::play_file(const std::string &path, const std::string &fat_path) {
+  if (this->source_ != VideoSource::FILE) {
+    ESP_LOGW(TAG, "Clip switching is only supported for file sources");
+    return false;
+  }
+  
+  // Garder le dernier frame de l'ancien clip pour la transition
+  this->transition_from_.reset();
+  if (this->transition_type_ != TransitionType::NONE && this->transition_duration_ > 0) {
+    this->transition_from_ = this->capture_outgoing_frame();
+  }
+  
+  this->close_file_source();
+  this->clip_path_ = path;
+  this->clip_fat_path_ = fat_path;
+  this->video_path_ = this->clip_path_.c_str();
+  this->fat_path_ = this->clip_fat_path_.empty() ? nullptr : this->clip_fat_path_.c_str();
+  if (!this->open_file_source()) {
+    this->transition_from_.reset();
+    return false;
+  }
+  ESP_LOGI(TAG, "Playing %s: %dx%d, %d frames%s", path.c_str(), this->video_width_, this->video_height_,
+           this->frame_count_, this->transition_from_ ? " (transition)" : "");
+  
+  // Réglage propre à chaque clip (enregistré, ou calibré au premier passage)
+  this->autotune_candidate_ = -1;
+  this->autotune_pending_ = this->autotune_;
+  
+  // La transition démarre avec le premier frame du nouveau clip
+  this->transition_start_ = 0;
+  this->transition_alpha_ = this->transition_from_ ? 0 : 32;
+  if (this->paused_) {
+    this->finished_ = false;
+    this->resume();
+  } else {
+    this->prewarm();
+    this->last_update_ = 0;
+  }
+  return true;
+}
+
+void VideoPlayerComponent::update_transition() {
+  const uint32_t now = millis();
+  if (this->transition_start_ == 0) {
+    this->transition_start_ = now;
+  }
+  const uint32_t elapsed = now - this->transition_start_;
+  if (elapsed >= this->transition_duration_) {
+    // Terminé : le frame sortant retourne au pool
+    this->transition_from_.reset();
+    this->transition_alpha_ = 32;
+    return;
+  }
+  this->transition_alpha_ = elapsed * 32 / this->transition_duration_;
+}
+
+void VideoPlayerComponent::transition_row(uint16_t *dst, uint32_t row, uint32_t frame_height, int vw) {
+  // Ligne correspondante du frame sortant (même hauteur relative que la ligne
+  // `row` du frame entrant), ramenée à la largeur de la zone : une seule passe
+  // supplémentaire par ligne, puis un noyau de mélange
+  const FrameInfo &from = this->transition_from_.info();
+  const uint32_t from_row = std::min<uint32_t>(row * from.height / frame_height, from.height - 1);
+  const uint16_t *pixels = (const uint16_t *) this->transition_from_.data();
+  uint16_t *out = this->transition_row_.data();
+  if (from.format == PixelFormat::RGB565_TILED) {
+    for (int x = 0; x < vw; x++) {
+      const uint16_t pixel = pixels[tiled_pixel_index(this->transition_x_map_[x], from_row, from.width)];
+      out[x] = this->color_lut_active_ ? this->apply_color_lut(pixel) : pixel;
+    }
+  } else {
+    const uint16_t *src_row = pixels + from_row * from.width;
+    if (this->color_lut_active_) {
+      for (int x = 0; x < vw; x++) {
+        out[x] = this->apply_color_lut(src_row[this->transition_x_map_[x]]);
+      }
+    } else {
+      for (int x = 0; x < vw; x++) {
+        out[x] = src_row[this->transition_x_map_[x]];
+      }
+    }
+  }
+  
+  const uint32_t alpha = this->transition_alpha_;
+  switch (this->transition_type_) {
+    case TransitionType::CROSSFADE:
+      // Le nouveau clip (dst) pèse alpha/32
+      rgb565_blend_row(dst, out, vw, alpha);
+      break;
+    case TransitionType::WIPE: {
+      // Le nouveau clip occupe déjà les colonnes à gauche de la frontière
+      const int edge = vw * alpha / 32;
+      memcpy(dst + edge, out + edge, (vw - edge) * sizeof(uint16_t));
+      break;
+    }
+    case TransitionType::SLIDE: {
+      // L'ancien clip sort par la gauche, le nouveau entre par la droite
+      const int shift = vw * alpha / 32;
+      const int entry = vw - shift;
+      memmove(dst + entry, dst, shift * sizeof(uint16_t));
+      memcpy(dst, out + shift, entry * sizeof(uint16_t));
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void VideoPlayerComponent::retain_last_frame() {
+  if (this->presented_index_ < 0 || this->last_frame_) {
+    return;
   }
+  const uint32_t index = this->presented_index_;
   
-  return false;
+  // Le frame est peut-être encore en cache : partager sa référence plutôt que le redécoder
+  CachedFrame *cached = this->find_cached_frame(index);
+  if (cached != nullptr) {
+    this->last_frame_ = cached->frame;
+    return;
+  }
+  if (index >= this->frame_index_.size()) {
+    return;
+  }
+  
+  // Redécoder le frame affiché sans perdre la position de lecture
+  const long position = this->video_file_ ? this->tell_file() : 0;
+  const uint32_t next_frame = this->next_frame_index_;
+  this->last_frame_ = this->decode_full(this->read_indexed_jpeg(index));
+  if (this->video_file_) {
+    this->seek_file(position);
+  }
+  this->next_frame_index_ = next_frame;
+}
+
+bool VideoPlayerComponent::drop_frame() {
+  // Avancer d'un frame sans le décoder
+  if (this->playback_mode_ != PlaybackMode::FORWARD && !this->frame_index_.empty()) {
+    this->frame_position_ = this->step_position();
+  } else if (!this->skip_frame()) {
+    return false;
+  }
+  this->frames_dropped_++;
+  return true;
+}
+
+bool VideoPlayerComponent::cpu_over_budget() const {
+  if (this->cpu_budget_ <= 0.0f || this->cpu_window_start_us_ == 0) {
+    return false;
+  }
+  // Le temps déjà consommé dans la fenêtre dépasse-t-il la part autorisée ?
+  const int64_t elapsed = esp_timer_get_time() - this->cpu_window_start_us_;
+  return this->cpu_busy_us_ > (int64_t) (this->cpu_budget_ * elapsed);
 }
 
-bool VideoPlayerComponent::process_frame(const uint8_t* jpeg_data, size_t jpeg_size) {
-  // Configurer une taille maximale pour le buffer RGB
-  const size_t max_rgb_buf_size = 256*256*2;  // 256x256 pixels maximum en RGB565
+void VideoPlayerComponent::account_cpu(int64_t busy_us) {
+  const int64_t now = esp_timer_get_time();
+  if (this->cpu_window_start_us_ == 0) {
+    this->cpu_window_start_us_ = now - busy_us;
+  }
+  this->cpu_busy_us_ += busy_us;
+  const int64_t elapsed = now - this->cpu_window_start_us_;
+  if (elapsed < CPU_WINDOW_US) {
+    return;
+  }
+  
+  this->cpu_load_ = (float) this->cpu_busy_us_ / elapsed;
+  this->cpu_busy_us_ = 0;
+  this->cpu_window_start_us_ = now;
+#ifdef USE_SENSOR
+  if (this->cpu_load_sensor_ != nullptr) {
+    this->cpu_load_sensor_->publish_state(this->cpu_load_ * 100.0f);
+  }
+#endif
   
-  // Calculer la taille réelle nécessaire
-  size_t rgb_buf_size = this->video_width_ * this->video_height_ * 2;  // 2 bytes par pixel pour RGB565
+  if (this->cpu_budget_ <= 0.0f) {
+    return;
+  }
+  // Des frames ont dû être sautés : décoder plus petit. Revenir en arrière seulement
+  // si le décodage à l'échelle supérieure (4 fois plus de pixels) tient dans le budget.
+  if (this->governor_window_drops_ > 0 && this->governor_scale_ < JPG_SCALE_MAX) {
+    this->governor_scale_++;
+    ESP_LOGI(TAG, "CPU budget exceeded (%.0f%%), decoding at an extra 1/%d", this->cpu_load_ * 100.0f,
+             1 << this->governor_scale_);
+  } else if (this->governor_window_drops_ == 0 && this->governor_scale_ > 0 &&
+             this->cpu_load_ * 4 < this->cpu_budget_) {
+    this->governor_scale_--;
+    ESP_LOGI(TAG, "CPU load %.0f%%, restoring decode scale", this->cpu_load_ * 100.0f);
+  }
+  this->governor_window_drops_ = 0;
+}
+
+void VideoPlayerComponent::set_brightness(float brightness) {
+  this->brightness_ = brightness;
+  this->color_lut_dirty_ = true;
+}
+
+void VideoPlayerComponent::set_contrast(float contrast) {
+  this->contrast_ = contrast;
+  this->color_lut_dirty_ = true;
+}
+
+void VideoPlayerComponent::set_gamma(float gamma) {
+  this->gamma_ = gamma;
+  this->color_lut_dirty_ = true;
+}
+
+void VideoPlayerComponent::rebuild_color_lut() {
+  this->color_lut_dirty_ = false;
+  this->color_lut_active_ = this->brightness_ != 0.0f || this->contrast_ != 1.0f || this->gamma_ != 1.0f;
+  if (!this->color_lut_active_) {
+    memcpy(this->palette_out_, this->palette_, sizeof(this->palette_out_));
+    return;
+  }
   
-  // Limiter la taille du buffer RGB
-  if (rgb_buf_size > max_rgb_buf_size) {
-    ESP_LOGW(TAG, "RGB buffer size too large (%d bytes), limiting to %d bytes", 
-             rgb_buf_size, max_rgb_buf_size);
-    rgb_buf_size = max_rgb_buf_size;
+  // v' = ((v - 0.5) * contraste + 0.5 + luminosité) ^ (1 / gamma), pour chaque niveau du canal
+  const float inv_gamma = 1.0f / std::max(this->gamma_, 0.1f);
+  auto build = [&](uint8_t *lut, int levels) {
+    for (int i = 0; i < levels; i++) {
+      float v = (float) i / (levels - 1);
+      v = (v - 0.5f) * this->contrast_ + 0.5f + this->brightness_;
+      v = std::min(std::max(v, 0.0f), 1.0f);
+      v = powf(v, inv_gamma);
+      lut[i] = (uint8_t) lroundf(v * (levels - 1));
+    }
+  };
+  build(this->lut_r_, 32);
+  build(this->lut_g_, 64);
+  build(this->lut_b_, 32);
+  // En mode palette, les réglages ne coûtent que 256 conversions
+  for (int i = 0; i < 256; i++) {
+    const uint16_t p = this->palette_[i];
+    this->palette_out_[i] = (this->lut_r_[p >> 11] << 11) | (this->lut_g_[(p >> 5) & 0x3F] << 5) | this->lut_b_[p & 0x1F];
+  }
+  ESP_LOGD(TAG, "Color LUT rebuilt: brightness %.2f, contrast %.2f, gamma %.2f", this->brightness_,
+           this->contrast_, this->gamma_);
+}
+
+jpg_scale_t VideoPlayerComponent::select_scale() const {
+  // Choisir la plus forte réduction DCT qui reste au moins aussi grande que la zone d'affichage
+  uint32_t needed_width = this->viewport_width_;
+  uint32_t needed_height = this->viewport_height_;
+  // Avec plusieurs écrans, la fenêtre la plus exigeante fixe la résolution du décodage
+  for (auto &output : this->outputs_) {
+    if (output.src_width > 0 && output.src_height > 0) {
+      needed_width = std::max<uint32_t>(needed_width,
+                                        output.display->get_width() * this->video_width_ / output.src_width);
+      needed_height = std::max<uint32_t>(needed_height,
+                                         output.display->get_height() * this->video_height_ / output.src_height);
+    } else {
+      needed_width = std::max<uint32_t>(needed_width, output.display->get_width());
+      needed_height = std::max<uint32_t>(needed_height, output.display->get_height());
+    }
   }
   
-  // Allouer le buffer RGB
-  uint8_t *rgb_buf = nullptr;
+  int scale = JPG_SCALE_NONE;
+  while (scale < JPG_SCALE_MAX &&
+         (this->video_width_ >> (scale + 1)) >= needed_width &&
+         (this->video_height_ >> (scale + 1)) >= needed_height) {
+    scale++;
+  }
+  // Réduction supplémentaire imposée par le gouverneur CPU
+  return (jpg_scale_t) std::min<int>(scale + this->governor_scale_, JPG_SCALE_MAX);
+}
+
+void VideoPlayerComponent::init_decoders() {
+  // Le décodeur matériel, s'il est fourni, passe en tête : c'est lui qu'on essaie en premier
+  this->decoders_.clear();
+  if (this->hardware_decode_) {
+    this->decoders_.emplace_back(new HardwareDecoderBackend(this->hardware_decode_));
+  }
+  this->decoders_.emplace_back(new BuiltinDecoderBackend());
+  this->decoders_.emplace_back(new TjpgdDecoderBackend());
+  // Seuls les décodeurs compilés pour cette cible restent candidats
+  this->decoders_.erase(std::remove_if(this->decoders_.begin(), this->decoders_.end(),
+                                       [](const std::unique_ptr<DecoderBackend> &decoder) {
+                                         return !decoder->is_available();
+                                       }),
+                        this->decoders_.end());
+  this->decoder_ = nullptr;
+  this->decoder_time_us_.assign(this->decoders_.size(), 0);
+  this->decoder_frame_us_ = 0;
+  this->benchmark_frames_left_ = 0;
   
-  // Essayer d'abord avec la mémoire interne
-  rgb_buf = (uint8_t *)heap_caps_malloc(rgb_buf_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-  if (!rgb_buf) {
-    // Si ça échoue, essayer avec SPIRAM
-    rgb_buf = (uint8_t *)heap_caps_malloc(rgb_buf_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    if (!rgb_buf) {
-      ESP_LOGE(TAG, "Failed to allocate RGB buffer (requested %d bytes)", rgb_buf_size);
-      return false;
+  if (strcmp(this->decoder_name_, "auto") != 0) {
+    for (auto &decoder : this->decoders_) {
+      if (strcmp(decoder->get_name(), this->decoder_name_) == 0) {
+        this->decoder_ = decoder.get();
+        return;
+      }
     }
+    ESP_LOGW(TAG, "Decoder '%s' not available, selecting automatically", this->decoder_name_);
+  }
+  this->benchmark_frames_left_ = this->benchmark_frames_;
+}
+
+void VideoPlayerComponent::set_hardware_decoder(HardwareDecodeFunction function) {
+  this->hardware_decode_ = std::move(function);
+  // Déjà initialisé : refaire la sélection avec ce nouveau candidat
+  if (!this->decoders_.empty()) {
+    this->init_decoders();
+  }
+}
+
+void VideoPlayerComponent::use_rans_codec(const uint8_t *tables, size_t size) {
+  auto *rans = new RansDecoderBackend();
+  if (!rans->load_tables(tables, size)) {
+    ESP_LOGE(TAG, "Invalid RANS tables, frames cannot be decoded");
+    delete rans;
+    return;
+  }
+  // Les frames ne sont pas des JPEG : le décodeur rANS est le seul possible
+  this->decoders_.clear();
+  this->decoders_.emplace_back(rans);
+  this->decoder_ = rans;
+  this->decoder_time_us_.assign(1, 0);
+  this->benchmark_frames_left_ = 0;
+  this->rans_codec_ = true;
+  ESP_LOGI(TAG, "Video uses the rANS codec");
+}
+
+bool VideoPlayerComponent::run_decoder(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out,
+                                       uint32_t width, uint32_t height) {
+  if (this->decoder_ != nullptr) {
+    return this->decoder_->decode(jpeg_data, jpeg_size, scale, out, width, height);
   }
   
-  // Utiliser un unique_ptr pour garantir la libération de mémoire
-  auto rgb_buf_guard = std::unique_ptr<uint8_t, std::function<void(uint8_t*)>>(
-    rgb_buf,
-    [](uint8_t* ptr) {
-      if (ptr != nullptr) {
-        heap_caps_free(ptr);
+  // Sans benchmark : le premier décodeur qui réussit est retenu. Pendant le
+  // benchmark, seul le premier succès écrit dans `out` ; les suivants décodent
+  // dans un bloc du pool, pour qu'un échec à mi-image n'abîme pas le frame.
+  bool decoded = false;
+  size_t first = 0;
+  uint8_t *scratch = nullptr;
+  for (size_t i = 0; i < this->decoders_.size(); i++) {
+    if (this->decoder_time_us_[i] < 0) {
+      continue;
+    }
+    uint8_t *target = out;
+    if (decoded) {
+      if (scratch == nullptr) {
+        scratch = VideoEngine::get()->acquire_buffer((size_t) width * height * 2);
+      }
+      if (scratch == nullptr) {
+        // Pas de place pour mesurer les autres : le premier qui a réussi est retenu
+        this->decoder_ = this->decoders_[first].get();
+        ESP_LOGW(TAG, "No pool memory for the decoder benchmark, using %s", this->decoder_->get_name());
+        return true;
       }
+      target = scratch;
     }
-  );
+    const int64_t start = esp_timer_get_time();
+    if (!this->decoders_[i]->decode(jpeg_data, jpeg_size, scale, target, width, height)) {
+      this->decoder_time_us_[i] = -1;  // Format non pris en charge : écarté
+      continue;
+    }
+    this->decoder_time_us_[i] += esp_timer_get_time() - start;
+    if (!decoded) {
+      first = i;
+      decoded = true;
+    }
+    esp_task_wdt_reset();
+    if (this->benchmark_frames_left_ == 0) {
+      this->decoder_ = this->decoders_[i].get();
+      this->decoder_frame_us_ = this->decoder_time_us_[i];
+      ESP_LOGI(TAG, "Decoder selected: %s", this->decoder_->get_name());
+      return true;
+    }
+  }
+  VideoEngine::get()->release_buffer(scratch);
+  if (!decoded || this->benchmark_frames_left_ == 0 || --this->benchmark_frames_left_ > 0) {
+    return decoded;
+  }
+  
+  // Fin du benchmark : le plus rapide sur le contenu réel l'emporte
+  const uint8_t frames = this->benchmark_frames_;
+  for (size_t i = 0; i < this->decoders_.size(); i++) {
+    if (this->decoder_time_us_[i] < 0) {
+      ESP_LOGI(TAG, "Decoder benchmark: %s unsupported", this->decoders_[i]->get_name());
+      continue;
+    }
+    ESP_LOGI(TAG, "Decoder benchmark: %s %lld us/frame", this->decoders_[i]->get_name(),
+             (long long) (this->decoder_time_us_[i] / frames));
+    if (this->decoder_ == nullptr || this->decoder_time_us_[i] / frames < this->decoder_frame_us_) {
+      this->decoder_ = this->decoders_[i].get();
+      this->decoder_frame_us_ = this->decoder_time_us_[i] / frames;
+    }
+  }
+  ESP_LOGI(TAG, "Decoder selected: %s", this->decoder_->get_name());
+  return true;
+}
+
+void VideoPlayerComponent::start_autotune() {
+  // Nouvelle calibration, même si un résultat est enregistré pour ce contenu
+  this->autotune_pending_ = true;
+  this->autotune_force_ = true;
+}
+
+uint32_t VideoPlayerComponent::autotune_key() const {
+  // Le résultat ne vaut que pour ce contenu, cette zone d'affichage et ce décodeur
+  char key[96];
+  snprintf(key, sizeof(key), "%ux%u@%u:%ux%u:%s", this->video_width_, this->video_height_, this->video_fps_,
+           this->viewport_width_, this->viewport_height_, this->get_decoder_name());
+  return fnv1_hash(key);
+}
+
+void VideoPlayerComponent::autotune_begin() {
+  this->autotune_pending_ = false;
+  const char *source = this->source_ == VideoSource::FILE ? this->video_path_ : this->http_url_;
+  this->autotune_pref_ = global_preferences->make_preference<AutotuneResult>(
+      fnv1_hash(std::string("video_player_autotune:") + (source != nullptr ? source : "")));
+  
+  // Résultat enregistré pour ce contenu : appliqué tel quel, sans calibration
+  const uint32_t key = this->autotune_key();
+  AutotuneResult saved;
+  if (!this->autotune_force_ && this->autotune_pref_.load(&saved) && saved.key == key) {
+    this->autotune_best_ = saved;
+    this->band_height_ = saved.band_height;
+    this->tiled_layout_ = saved.tiled;
+    ESP_LOGI(TAG, "Autotune: %d-row bands, %s layout (%.1f FPS, saved)", saved.band_height,
+             saved.tiled ? "tiled" : "linear", 1e6f / std::max<uint32_t>(saved.frame_us, 1));
+    return;
+  }
+  this->autotune_force_ = false;
+  
+  // Les tuiles ne sont candidates que si le décodeur retenu sait les écrire
+  this->autotune_candidates_ = AUTOTUNE_BAND_COUNT;
+  if (this->decoder_->supports_tiled() && this->palette_lut_ == nullptr) {
+    this->autotune_candidates_ *= 2;
+  }
+  this->autotune_best_ = AutotuneResult{key, this->band_height_, this->tiled_layout_, UINT32_MAX};
+  ESP_LOGI(TAG, "Autotune: calibrating %d configurations, %d frames each", this->autotune_candidates_,
+           this->autotune_frames_);
+  this->apply_autotune_candidate(0);
+}
+
+void VideoPlayerComponent::apply_autotune_candidate(int candidate) {
+  this->autotune_candidate_ = candidate;
+  this->band_height_ = AUTOTUNE_BAND_HEIGHTS[candidate % AUTOTUNE_BAND_COUNT];
+  this->tiled_layout_ = candidate >= AUTOTUNE_BAND_COUNT;
+  this->autotune_frames_left_ = this->autotune_frames_;
+  this->autotune_time_us_ = 0;
+  this->autotune_misses_ = 0;
+  // Le premier frame réserve les nouveaux buffers : il n'est pas compté
+  this->autotune_warmup_ = true;
+}
+
+void VideoPlayerComponent::autotune_step(bool presented, int64_t work_us) {
+  if (!presented) {
+    // Fin de vidéo ou attente du réseau ; trop d'échecs d'affilée : la
+    // configuration ne tient pas dans le budget mémoire, elle est écartée
+    if (++this->autotune_misses_ <= this->autotune_frames_) {
+      return;
+    }
+    ESP_LOGI(TAG, "Autotune: %d-row bands, %s layout rejected", this->band_height_,
+             this->tiled_layout_ ? "tiled" : "linear");
+  } else {
+    this->autotune_misses_ = 0;
+    if (this->autotune_warmup_) {
+      this->autotune_warmup_ = false;
+      return;
+    }
+    this->autotune_time_us_ += work_us;
+    if (--this->autotune_frames_left_ > 0) {
+      return;
+    }
+    const uint32_t frame_us = this->autotune_time_us_ / this->autotune_frames_;
+    ESP_LOGD(TAG, "Autotune: %d-row bands, %s layout: %u us/frame, pool %u bytes", this->band_height_,
+             this->tiled_layout_ ? "tiled" : "linear", frame_us, VideoEngine::get()->get_allocated());
+    if (frame_us < this->autotune_best_.frame_us) {
+      this->autotune_best_.band_height = this->band_height_;
+      this->autotune_best_.tiled = this->tiled_layout_;
+      this->autotune_best_.frame_us = frame_us;
+    }
+  }
+  
+  if (this->autotune_candidate_ + 1 < this->autotune_candidates_) {
+    this->apply_autotune_candidate(this->autotune_candidate_ + 1);
+    return;
+  }
+  
+  // Fin de la calibration : meilleure configuration appliquée et enregistrée
+  this->autotune_candidate_ = -1;
+  this->band_height_ = this->autotune_best_.band_height;
+  this->tiled_layout_ = this->autotune_best_.tiled;
+  if (this->autotune_best_.frame_us == UINT32_MAX) {
+    ESP_LOGW(TAG, "Autotune: no configuration could be measured, keeping the configured values");
+    return;
+  }
+  this->autotune_pref_.save(&this->autotune_best_);
+  global_preferences->sync();
+  ESP_LOGI(TAG, "Autotune: %d-row bands, %s layout selected (%.1f FPS sustained)", this->band_height_,
+           this->tiled_layout_ ? "tiled" : "linear", 1e6f / std::max<uint32_t>(this->autotune_best_.frame_us, 1));
+}
+
+FrameRef VideoPlayerComponent::decode_frame(const FrameRef &jpeg, jpg_scale_t scale) {
+  if (!jpeg) {
+    return FrameRef();
+  }
+  const uint32_t width = this->video_width_ >> scale;
+  const uint32_t height = this->video_height_ >> scale;
+  
+  // Disposition en tuiles si le décodeur retenu écrit bloc par bloc (la
+  // quantification vers la palette lit les pixels dans l'ordre des lignes)
+  const bool tiled = this->tiled_layout_ && this->decoder_ != nullptr && this->decoder_->supports_tiled() &&
+                     this->palette_lut_ == nullptr;
   
-  // Déterminer l'échelle à utiliser
-  jpg_scale_t scale = JPG_SCALE_NONE;
+  // Le buffer RGB ne contient que l'image réduite : 2 octets par pixel pour RGB565
+  size_t rgb_buf_size = tiled ? tiled_frame_pixels(width, height) * 2 : width * height * 2;
   
-  // Si la vidéo est trop grande, on utilise un scaling
-  if (this->video_width_ > display_->get_width() * 2 || 
-      this->video_height_ > display_->get_height() * 2) {
-    scale = JPG_SCALE_2X;
-    ESP_LOGD(TAG, "Using 2x downscaling for JPEG");
+  // Emprunter le buffer RGB au pool partagé
+  FrameRef rgb = tiled ? FrameRef::from_pool_aligned(rgb_buf_size, FRAME_TILE_ALIGN) : FrameRef::from_pool(rgb_buf_size);
+  if (!rgb) {
+    ESP_LOGE(TAG, "Failed to allocate RGB buffer (requested %d bytes)", rgb_buf_size);
+    return rgb;
   }
   
   // Réinitialiser le watchdog avant la conversion JPEG
   esp_task_wdt_reset();
   
   // Convertir JPEG en RGB565
-  bool conversion_success = jpg2rgb565(jpeg_data, jpeg_size, rgb_buf, scale);
+  const bool decoded = tiled ? this->decoder_->decode_tiled(jpeg.data(), jpeg.size(), scale, rgb.mutable_data(),
+                                                            width, height)
+                             : this->run_decoder(jpeg.data(), jpeg.size(), scale, rgb.mutable_data(), width, height);
+  if (!decoded) {
+    ESP_LOGE(TAG, "JPEG conversion failed");
+    return FrameRef();
+  }
+  FrameInfo &info = rgb.info();
+  info.index = jpeg.info().index;
+  info.timestamp = jpeg.info().timestamp;
+  info.width = width;
+  info.height = height;
+  info.format = tiled ? PixelFormat::RGB565_TILED : PixelFormat::RGB565;
+  info.flags = FRAME_DECODED | (scale != this->select_scale() ? FRAME_PREVIEW : 0);
+  return rgb;
+}
+
+FrameRef VideoPlayerComponent::extract_alpha_mask(const FrameRef &jpeg) const {
+  // Charge utile : JPEG | masque | uint32 taille du masque. Les décodeurs
+  // s'arrêtent au marqueur de fin du JPEG et ignorent ce qui suit.
+  // Masque : uint32 position de chaque ligne (hauteur de la vidéo), puis des
+  // plages uint16 par ligne (4 bits d'alpha 0..15, 12 bits de longueur).
+  uint32_t mask_size;
+  if (!jpeg || jpeg.size() < sizeof(mask_size)) {
+    return FrameRef();
+  }
+  memcpy(&mask_size, jpeg.data() + jpeg.size() - sizeof(mask_size), sizeof(mask_size));
+  const size_t table_size = this->video_height_ * sizeof(uint32_t);
+  if (mask_size < table_size || mask_size + sizeof(mask_size) > jpeg.size()) {
+    ESP_LOGW(TAG, "Frame %u has no valid alpha mask", jpeg.info().index);
+    return FrameRef();
+  }
+  const uint8_t *mask = jpeg.data() + jpeg.size() - sizeof(mask_size) - mask_size;
   
-  if (conversion_success) {
-    // Calculer les dimensions après scaling
-    uint32_t scaled_width = (scale == JPG_SCALE_NONE) ? this->video_width_ : (this->video_width_ / 2);
-    uint32_t scaled_height = (scale == JPG_SCALE_NONE) ? this->video_height_ : (this->video_height_ / 2);
-    
-    // Calculer les facteurs de mise à l'échelle pour l'affichage
-    float scale_x = (float)scaled_width / display_->get_width();
-    float scale_y = (float)scaled_height / display_->get_height();
-    
-    // Réinitialiser le watchdog avant le rendu
+  // Valider une fois ici pour que le blit puisse parcourir les plages sans contrôle
+  for (uint32_t y = 0; y < this->video_height_; y++) {
+    uint32_t offset;
+    memcpy(&offset, mask + y * sizeof(offset), sizeof(offset));
+    uint32_t covered = 0;
+    while (covered < this->video_width_) {
+      uint16_t run;
+      if (offset + sizeof(run) > mask_size) {
+        ESP_LOGW(TAG, "Frame %u: alpha mask truncated", jpeg.info().index);
+        return FrameRef();
+      }
+      memcpy(&run, mask + offset, sizeof(run));
+      offset += sizeof(run);
+      if ((run & 0x0FFF) == 0) {
+        ESP_LOGW(TAG, "Frame %u: empty alpha run", jpeg.info().index);
+        return FrameRef();
+      }
+      covered += run & 0x0FFF;
+    }
+  }
+  return jpeg.extract(mask - jpeg.data(), mask_size);
+}
+
+FrameRef VideoPlayerComponent::decode_full(const FrameRef &jpeg) {
+  // Déterminer l'échelle à utiliser en fonction de la zone d'affichage (écran ou cellule)
+  FrameRef frame = this->decode_frame(jpeg, this->select_scale());
+  
+  // Le masque alpha suit le frame décodé (cache, pause) sans garder le JPEG
+  if (frame && this->alpha_bits_ != 0) {
+    frame.attach(this->extract_alpha_mask(jpeg));
+  }
+  
+  // Mode palette : le frame retenu n'occupe plus qu'un octet par pixel
+  if (frame && this->palette_lut_ != nullptr) {
+    FrameRef indexed = this->quantize_frame(frame);
+    if (indexed) {
+      return indexed;
+    }
+  }
+  return frame;
+}
+
+bool VideoPlayerComponent::process_frame(const FrameRef &jpeg) {
+  FrameRef frame = this->decode_full(jpeg);
+  if (!frame) {
+    return false;
+  }
+  if (this->transition_from_) {
+    this->update_transition();
+  }
+  
+  // Réinitialiser le watchdog avant le rendu
+  esp_task_wdt_reset();
+  
+  bool success = this->blit_frame(frame);
+  ESP_LOGD(TAG, "Frame converted and drawn");
+  if (!success) {
+    return false;
+  }
+  this->presented_index_ = frame.info().index;
+  this->publish_snapshot(jpeg);
+  
+  // Garder le frame décodé pour un prochain passage (lecture inversée, aller-retour) :
+  // le cache partage la référence, sans copie
+  if (this->frame_cache_size_ > 0 && this->playback_mode_ != PlaybackMode::FORWARD &&
+      this->find_cached_frame(frame.info().index) == nullptr) {
+    this->cache_frame(frame);
+  }
+  return true;
+}
+
+bool VideoPlayerComponent::blit_frame(const uint8_t *pixels, uint32_t src_width, uint32_t src_height,
+                                      PixelFormat format, const uint8_t *alpha) {
+  if (this->outputs_.empty() || this->video_width_ == 0 || this->video_height_ == 0) {
+    return this->blit_frame_to(pixels, src_width, src_height, this->viewport_x_, this->viewport_y_,
+                               this->viewport_width_, this->viewport_height_, format, alpha);
+  }
+  
+  // Un seul décodage réparti sur tous les écrans, chacun avec sa fenêtre dans la vidéo
+  bool result = true;
+  for (auto &output : this->outputs_) {
+    uint32_t sx = 0, sy = 0, sw = src_width, sh = src_height;
+    if (output.src_width > 0 && output.src_height > 0) {
+      // Fenêtre exprimée en pixels de la vidéo, ramenée à l'échelle du frame décodé
+      sx = std::min<uint32_t>(output.src_x * src_width / this->video_width_, src_width - 1);
+      sy = std::min<uint32_t>(output.src_y * src_height / this->video_height_, src_height - 1);
+      sw = std::min<uint32_t>(std::max<uint32_t>(output.src_width * src_width / this->video_width_, 1), src_width - sx);
+      sh = std::min<uint32_t>(std::max<uint32_t>(output.src_height * src_height / this->video_height_, 1),
+                              src_height - sy);
+    }
+    result &= this->blit_region(output.display, pixels, src_width, src_height, sx, sy, sw, sh, 0, 0,
+                                output.display->get_width(), output.display->get_height(), format, alpha);
     esp_task_wdt_reset();
-    
-    // Dessiner sur l'écran
-    for (int y = 0; y < (int)display_->get_height(); y++) {
-      int src_y = (int)(y * scale_y);
-      if (src_y >= (int)scaled_height) continue;
-      
-      for (int x = 0; x < (int)display_->get_width(); x++) {
-        int src_x = (int)(x * scale_x);
-        if (src_x >= (int)scaled_width) continue;
-        
-        // Pour RGB565, chaque pixel fait 2 octets
-        int idx = (src_y * scaled_width + src_x) * 2;
-        
-        // Vérifier les bornes
-        if (idx + 1 >= (int)rgb_buf_size) continue;
-        
-        uint16_t pixel = (rgb_buf[idx + 1] << 8) | rgb_buf[idx];
-        
-        // Convertir RGB565 en RGB888
-        uint8_t r = ((pixel >> 11) & 0x1F) << 3;
-        uint8_t g = ((pixel >> 5) & 0x3F) << 2;
-        uint8_t b = (pixel & 0x1F) << 3;
-        
-        display_->draw_pixel_at(x, y, Color(r, g, b));
-      }
-    }
-    ESP_LOGD(TAG, "Frame converted and drawn");
+  }
+  return result;
+}
+
+bool VideoPlayerComponent::blit_frame_to(const uint8_t *pixels, uint32_t src_width, uint32_t src_height,
+                                         int dst_x, int dst_y, int vw, int vh, PixelFormat format,
+                                         const uint8_t *alpha) {
+  return this->blit_region(this->display_, pixels, src_width, src_height, 0, 0, src_width, src_height, dst_x, dst_y,
+                           vw, vh, format, alpha);
+}
+
+void VideoPlayerComponent::convert_row(const uint8_t *pixels, uint32_t row, uint32_t stride, PixelFormat format,
+                                       uint16_t *dst, int x_begin, int x_end) {
+  if (format == PixelFormat::INDEXED8) {
+    // Expansion vers le format de l'écran uniquement pendant l'envoi
+    const uint8_t *src_row = pixels + row * stride;
+    for (int x = x_begin; x < x_end; x++) {
+      dst[x] = this->palette_out_[src_row[this->x_map_[x]]];
+    }
+  } else if (format == PixelFormat::RGB565_TILED) {
+    // Remise en lignes fusionnée avec l'envoi : la rangée de tuiles est fixe
+    // pour toute la ligne, seule la colonne change de tuile tous les 16 pixels
+    const uint16_t *tile_row = (const uint16_t *) pixels + tiled_pixel_index(0, row, stride);
+    for (int x = x_begin; x < x_end; x++) {
+      const uint32_t sx = this->x_map_[x];
+      const uint16_t pixel = tile_row[((sx >> 4) << 8) | (sx & 15)];
+      dst[x] = this->color_lut_active_ ? this->apply_color_lut(pixel) : pixel;
+    }
+  } else if (this->color_lut_active_) {
+    // Réglages d'image appliqués pendant la copie : aucune passe supplémentaire
+    const uint16_t *src_row = (const uint16_t *) pixels + row * stride;
+    for (int x = x_begin; x < x_end; x++) {
+      dst[x] = this->apply_color_lut(src_row[this->x_map_[x]]);
+    }
   } else {
-    ESP_LOGE(TAG, "JPEG conversion failed");
+    const uint16_t *src_row = (const uint16_t *) pixels + row * stride;
+    for (int x = x_begin; x < x_end; x++) {
+      dst[x] = src_row[this->x_map_[x]];
+    }
+  }
+}
+
+void VideoPlayerComponent::blit_alpha_row(display::Display *target, uint16_t *dst, const uint8_t *pixels,
+                                          uint32_t row, uint32_t stride, PixelFormat format, const uint8_t *alpha,
+                                          int dst_x, int y, int vw) {
+  // Le masque est à la résolution de la vidéo, le frame à l'échelle de décodage
+  const uint32_t factor = std::max<uint32_t>(this->video_width_ / stride, 1);
+  uint32_t offset;
+  memcpy(&offset, alpha + std::min(row * factor, this->video_height_ - 1) * sizeof(offset), sizeof(offset));
+  const uint8_t *run = alpha + offset;
+  
+  uint32_t run_end = 0;
+  uint8_t level = 0;
+  int segment = -1;  // début du segment visible en cours
+  int x = 0;
+  this->alpha_segments_.clear();
+  while (x < vw) {
+    const uint32_t column = this->x_map_[x] * factor;
+    while (column >= run_end) {
+      uint16_t value;
+      memcpy(&value, run, sizeof(value));
+      run += sizeof(value);
+      level = value >> 12;
+      run_end += value & 0x0FFF;
+    }
+    // Colonnes de destination couvertes par cette plage
+    int x_end = x + 1;
+    while (x_end < vw && this->x_map_[x_end] * factor < run_end) {
+      x_end++;
+    }
+    
+    if (level == 0) {
+      // Plage transparente : rien n'est converti ni envoyé, l'interface reste visible
+      if (segment >= 0) {
+        this->alpha_segments_.push_back({segment, x});
+        segment = -1;
+      }
+    } else {
+      if (segment < 0) {
+        segment = x;
+      }
+      this->convert_row(pixels, row, stride, format, dst, x, x_end);
+      if (level < 15) {
+        // Bord semi-transparent : mélange avec la couleur de fond
+        const uint32_t weight = (level * 32 + 7) / 15;
+        for (int i = x; i < x_end; i++) {
+          dst[i] = rgb565_blend(dst[i], this->alpha_matte_, weight);
+        }
+      }
+    }
+    x = x_end;
+  }
+  if (segment >= 0) {
+    this->alpha_segments_.push_back({segment, vw});
+  }
+  if (this->alpha_segments_.empty()) {
+    return;
+  }
+  
+  // Les sprites n'apparaissent que sur les parties visibles de la vidéo
+  for (auto *sprite : this->overlays_) {
+    if (target == this->display_ && sprite->covers_row(y)) {
+      sprite->composite_row(dst, dst_x, vw, y);
+    }
+  }
+  for (const auto &seg : this->alpha_segments_) {
+    target->draw_pixels_at(dst_x + seg.first, y, seg.second - seg.first, 1, (const uint8_t *) (dst + seg.first),
+                           display::COLOR_ORDER_RGB, display::COLOR_BITNESS_565, false);
+  }
+}
+
+bool VideoPlayerComponent::blit_region(display::Display *target, const uint8_t *pixels, uint32_t stride,
+                                       uint32_t frame_height, uint32_t src_x, uint32_t src_y, uint32_t src_width,
+                                       uint32_t src_height, int dst_x, int dst_y, int vw, int vh, PixelFormat format,
+                                       const uint8_t *alpha) {
+  if (vw <= 0 || vh <= 0) {
+    return false;
+  }
+  
+  // Table des colonnes source, recalculée seulement si la fenêtre change
+  if (this->x_map_.size() != (size_t) vw || this->x_map_src_x_ != src_x || this->x_map_src_width_ != src_width) {
+    this->x_map_.resize(vw);
+    for (int x = 0; x < vw; x++) {
+      this->x_map_[x] = (uint16_t) (src_x + (uint32_t) x * src_width / vw);
+    }
+    this->x_map_src_x_ = src_x;
+    this->x_map_src_width_ = src_width;
+  }
+  
+  // Écrire par bandes de lignes directement dans la zone d'affichage
+  const int band_rows = std::min<int>(this->band_height_, vh);
+  uint16_t *band = (uint16_t *) VideoEngine::get()->acquire_buffer(vw * band_rows * 2);
+  if (!band) {
+    ESP_LOGE(TAG, "Failed to allocate band buffer");
+    return false;
+  }
+  
+  if (this->color_lut_dirty_) {
+    this->rebuild_color_lut();
+  }
+  
+  // Redessiner les sprites dont le contenu a changé, une seule fois
+  for (auto *sprite : this->overlays_) {
+    sprite->render_if_dirty();
+  }
+  
+  // Transition en cours : colonnes correspondantes dans le frame sortant
+  // (même fenêtre relative, quelle que soit son échelle de décodage)
+  const bool transition = this->transition_from_ && this->transition_alpha_ < 32 && alpha == nullptr;
+  if (transition) {
+    const uint32_t from_width = this->transition_from_.info().width;
+    this->transition_x_map_.resize(vw);
+    this->transition_row_.resize(vw);
+    for (int x = 0; x < vw; x++) {
+      this->transition_x_map_[x] = (uint16_t) std::min<uint32_t>(this->x_map_[x] * from_width / stride,
+                                                                 from_width - 1);
+    }
+  }
+  
+  for (int y0 = 0; y0 < vh; y0 += band_rows) {
+    const int rows = std::min(band_rows, vh - y0);
+    for (int r = 0; r < rows; r++) {
+      const uint32_t row = src_y + (uint32_t) (y0 + r) * src_height / vh;
+      uint16_t *dst = band + r * vw;
+      if (alpha != nullptr) {
+        // Vidéo détourée : seuls les segments visibles de la ligne sont envoyés
+        this->blit_alpha_row(target, dst, pixels, row, stride, format, alpha, dst_x, dst_y + y0 + r, vw);
+        continue;
+      }
+      this->convert_row(pixels, row, stride, format, dst, 0, vw);
+      if (transition) {
+        this->transition_row(dst, row, frame_height, vw);
+      }
+      // Composer les sprites directement dans la bande, seulement sur leurs lignes
+      // (ils sont placés dans les coordonnées de l'écran principal)
+      for (auto *sprite : this->overlays_) {
+        if (target == this->display_ && sprite->covers_row(dst_y + y0 + r)) {
+          sprite->composite_row(dst, dst_x, vw, dst_y + y0 + r);
+        }
+      }
+    }
+    if (alpha == nullptr) {
+      target->draw_pixels_at(dst_x, dst_y + y0, vw, rows, (const uint8_t *) band,
+                             display::COLOR_ORDER_RGB, display::COLOR_BITNESS_565, false);
+    }
   }
   
-  // rgb_buf sera automatiquement libéré par rgb_buf_guard
-  return conversion_success;
+  VideoEngine::get()->release_buffer((uint8_t *) band);
+  return true;
 }
 
 void VideoPlayerComponent::loop() {
-  const uint32_t now = millis();
+  // Le gouverneur compte tout le passage (prélecture HTTP, index, horloge
+  // réseau, sprites, flush) et pas seulement le décodage, moins la cession
+  // de tâche qui laisse justement la main aux autres
+  const int64_t loop_start = esp_timer_get_time();
+  this->loop_yield_us_ = 0;
+  this->run_loop(millis());
+  this->account_cpu(esp_timer_get_time() - loop_start - this->loop_yield_us_);
+}
+
+void VideoPlayerComponent::run_loop(uint32_t now) {
+  // Reposée juste avant claim_slot : un lecteur qui attend l'horloge média ou
+  // un déplacement ne compte pas parmi les candidats des autres lecteurs
+  this->decode_ready_ = false;
+  this->service_snapshot(now);
+  
+  // En pause : aucun décodage ; seuls les sprites modifiés sont redessinés
+  // par-dessus le dernier frame conservé
+  if (this->paused_) {
+    if (this->last_frame_ &&
+        std::any_of(this->overlays_.begin(), this->overlays_.end(),
+                    [](const OverlaySprite *sprite) { return sprite->is_dirty(); })) {
+      if (this->blit_frame(this->last_frame_)) {
+        this->schedule_flush();
+      }
+    }
+    return;
+  }
   
   // Vérifier si HTTP a besoin d'initialisation
   if (this->source_ == VideoSource::HTTP && !this->http_initialized_) {
@@ -632,19 +2687,105 @@ void VideoPlayerComponent::loop() {
     }
   }
   
-  if (now - last_update_ < update_interval_) {
+  // Lecture anticipée HTTP au débit accordé par l'arbitre réseau
+  this->http_prefetch();
+  
+  // Pendant un déplacement, la lecture est suspendue ; une fois l'utilisateur
+  // arrêté, le frame visé est redécodé en pleine qualité puis la lecture reprend.
+  if (this->scrubbing_) {
+    if (now - this->last_scrub_ < SCRUB_REFINE_DELAY_MS) {
+      return;
+    }
+    this->scrubbing_ = false;
+    // Reprendre sur le frame visé : le chemin normal le redécode en pleine
+    // qualité puis avance dans le sens de lecture
+    this->seek_position(this->scrub_target_);
+    if (this->present_next_frame()) {
+      this->schedule_flush();
+    }
+    this->last_update_ = now;
+    return;
+  }
+  
+  // Démarrer la synchronisation réseau dès que le réseau est prêt
+  bool synced = false;
+  // (la lecture synchronisée ne s'applique qu'à la lecture vers l'avant)
+  if (this->clock_sync_ && this->playback_mode_ == PlaybackMode::FORWARD) {
+    if (!this->clock_sync_->is_started() && now - this->last_sync_start_attempt_ > 5000) {
+      this->last_sync_start_attempt_ = now;
+      if (esp_netif_get_handle_from_ifkey("WIFI_STA_DEF") != NULL) {
+        this->clock_sync_->start();
+      }
+    }
+    this->clock_sync_->poll();
+    int64_t media_ms;
+    synced = this->clock_sync_->get_media_time_ms(&media_ms);
+  }
+  
+  if (synced) {
+    // Présentation pilotée par l'horloge média partagée plutôt que par millis()
+    if (!this->sync_frame_due()) {
+      this->index_step(INDEX_STEP_BUDGET_US);
+      return;
+    }
+  } else if (now - last_update_ < update_interval_) {
+    // Temps libre : avancer un peu la construction de l'index
+    this->index_step(INDEX_STEP_BUDGET_US);
+    return;
+  }
+  
+  // Laisser passer le lecteur le plus en retard s'il y en a plusieurs
+  this->decode_ready_ = true;
+  if (!VideoEngine::get()->claim_slot(this, now)) {
     return;
   }
+  this->decode_ready_ = false;
+  
+  // Rattraper le retard en sautant des frames sans les décoder
+  if (!synced && this->last_update_ != 0 && this->update_interval_ > 0) {
+    uint32_t frames_late = (now - this->get_next_deadline()) / this->update_interval_;
+    frames_late = std::min(frames_late, MAX_FRAME_DROP);
+    for (; frames_late > 0; frames_late--) {
+      if (!this->drop_frame()) {
+        break;
+      }
+    }
+  }
   last_update_ = now;
   
+  // Budget CPU dépassé sur la fenêtre en cours : sauter ce frame plutôt
+  // que d'affamer les autres composants (capteurs, BLE, API)
+  if (this->cpu_over_budget()) {
+    if (this->drop_frame()) {
+      this->governor_drops_++;
+      this->governor_window_drops_++;
+    }
+    return;
+  }
+  
   // Cession de tâche plus longue pour éviter d'affamer la pile réseau
+  const int64_t yield_start = esp_timer_get_time();
   vTaskDelay(pdMS_TO_TICKS(5));
+  this->loop_yield_us_ = esp_timer_get_time() - yield_start;
   
   // Réinitialiser le watchdog avant le traitement du frame
   esp_task_wdt_reset();
   
-  if (read_next_frame()) {
-    display_->update();
+  const int64_t work_start = esp_timer_get_time();
+  const bool presented = this->present_next_frame();
+  const int64_t work_us = esp_timer_get_time() - work_start;
+  
+  // Réglage automatique, une fois le décodeur choisi
+  if (this->autotune_candidate_ >= 0) {
+    this->autotune_step(presented, work_us);
+  } else if (this->autotune_pending_ && this->decoder_ != nullptr) {
+    this->autotune_begin();
+  }
+  
+  if (presented) {
+    this->mark_first_frame();
+    // Un seul rafraîchissement par écran et par passage, même avec plusieurs cellules
+    this->schedule_flush();
     this->current_frame_++;
     
     // Pour déboguer la mémoire
@@ -660,11 +2801,75 @@ void VideoPlayerComponent::dump_info() {
   ESP_LOGCONFIG(TAG, "  Resolution: %dx%d", this->video_width_, this->video_height_);
   ESP_LOGCONFIG(TAG, "  Frames: %d", this->frame_count_);
   ESP_LOGCONFIG(TAG, "  FPS: %d", this->video_fps_);
+  ESP_LOGCONFIG(TAG, "  Viewport: %dx%d at (%d,%d), decode scale 1/%d", this->viewport_width_,
+                this->viewport_height_, this->viewport_x_, this->viewport_y_, 1 << this->select_scale());
+  ESP_LOGCONFIG(TAG, "  Time to first frame: %u ms%s", (uint32_t) (this->time_to_first_frame_us_ / 1000),
+                this->poster_offset_ != 0 ? " (poster)" : "");
+  if (this->decoder_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Decoder: %s (%s, %lld us/frame at boot)", this->decoder_->get_name(),
+                  strcmp(this->decoder_name_, "auto") == 0 ? "auto" : "forced", (long long) this->decoder_frame_us_);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Decoder: not selected yet (%s)", this->decoder_name_);
+  }
+  ESP_LOGCONFIG(TAG, "  State: %s%s", this->finished_ ? "finished" : this->paused_ ? "paused" : "playing",
+                this->last_frame_ ? " (last frame kept)" : "");
+  ESP_LOGCONFIG(TAG, "  Dropped frames: %u", this->frames_dropped_);
+  if (this->cpu_budget_ > 0.0f) {
+    ESP_LOGCONFIG(TAG, "  CPU budget: %.0f%% (load %.0f%%, %u frames dropped, extra scale 1/%d)",
+                  this->cpu_budget_ * 100.0f, this->cpu_load_ * 100.0f, this->governor_drops_,
+                  1 << this->governor_scale_);
+  }
+  ESP_LOGCONFIG(TAG, "  Frame index: %u frames%s", this->frame_index_.size(),
+                this->index_complete_ ? "" : " (building)");
+  ESP_LOGCONFIG(TAG, "  Playback: %s, frame cache %u (%u hits)",
+                this->playback_mode_ == PlaybackMode::FORWARD ? "forward" :
+                this->playback_mode_ == PlaybackMode::REVERSE ? "reverse" : "ping-pong",
+                this->frame_cache_size_, this->cache_hits_);
+  for (auto &output : this->outputs_) {
+    ESP_LOGCONFIG(TAG, "  Output: %dx%d display, source %ux%u at (%u,%u)", output.display->get_width(),
+                  output.display->get_height(), output.src_width, output.src_height, output.src_x, output.src_y);
+  }
+  if (this->autotune_) {
+    const char *state = this->autotune_candidate_ >= 0 ? "calibrating" : this->autotune_pending_ ? "pending" : "done";
+    ESP_LOGCONFIG(TAG, "  Autotune: %s, %d-row bands%s", state, this->band_height_, this->autotune_best_.frame_us != UINT32_MAX ? "" : " (not measured)");
+  }
+  if (this->tiled_layout_) {
+    ESP_LOGCONFIG(TAG, "  Frame layout: 16x16 tiles%s",
+                  this->decoder_ != nullptr && !this->decoder_->supports_tiled() ? " (linear with this decoder)" : "");
+  }
+  if (this->palette_mode_) {
+    ESP_LOGCONFIG(TAG, "  Pixel format: %s", this->palette_lut_ != nullptr ? "8-bit palette" : "RGB565 (no palette)");
+  }
+  if (this->extent_reader_) {
+    ESP_LOGCONFIG(TAG, "  Raw SD reads: %u extents", this->extent_reader_->get_extent_count());
+  }
+  if (this->alpha_bits_ != 0) {
+    ESP_LOGCONFIG(TAG, "  Alpha mask: %d bits, matte 0x%04X", this->alpha_bits_, this->alpha_matte_);
+  }
+  if (this->clock_sync_) {
+    ESP_LOGCONFIG(TAG, "  Sync: %s, %s, offset %lld us, delay %lld us, held %u",
+                  this->clock_sync_->get_role() == SyncRole::LEADER ? "leader" : "follower",
+                  this->clock_sync_->is_synced() ? "synced" : "not synced",
+                  (long long) this->clock_sync_->get_offset_us(), (long long) this->clock_sync_->get_delay_us(),
+                  this->frames_held_);
+  }
+  ESP_LOGCONFIG(TAG, "  Shared pool: %u/%u bytes, %u player(s)", VideoEngine::get()->get_allocated(),
+                VideoEngine::get()->get_memory_budget(), VideoEngine::get()->get_player_count());
   ESP_LOGCONFIG(TAG, "  Source: %s", this->source_ == VideoSource::FILE ? "File" : "HTTP");
   if (this->source_ == VideoSource::FILE) {
     ESP_LOGCONFIG(TAG, "  File: %s", this->video_path_);
   } else {
     ESP_LOGCONFIG(TAG, "  URL: %s", this->http_url_);
+    const size_t received = this->http_stream_offset_ + this->http_buffer_size_used_;
+    if (this->http_content_length_ == HTTP_UNKNOWN_LENGTH) {
+      ESP_LOGCONFIG(TAG, "  Download: %u bytes of unknown length%s, lead buffer %u bytes, weight %d", received,
+                    this->http_client_ != nullptr ? " (in progress)" : "", this->http_buffer_size_,
+                    this->network_weight_);
+    } else {
+      ESP_LOGCONFIG(TAG, "  Download: %u/%u bytes%s, lead buffer %u bytes, weight %d", received,
+                    this->http_content_length_, this->http_client_ != nullptr ? " (in progress)" : "",
+                    this->http_buffer_size_, this->network_weight_);
+    }
   }
 }
 
@@ -1,10 +1,32 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/display/display.h"
 #include "esp_err.h"
+#include "esp_http_client.h"
+#include "esp_jpg_decode.h"
+#include "clock_sync.h"
+#include "decoder_backend.h"
+#include "frame_ref.h"
+#include "overlay.h"
+#include "rgb565.h"
+#include "sd_extents.h"
+
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace esphome {
+namespace web_server_base {
+class WebServerBase;
+}  // namespace web_server_base
+
 namespace video_player {
 
 enum class VideoSource {
@@ -12,6 +34,43 @@ enum class VideoSource {
   HTTP
 };
 
+// Passage d'un clip au suivant (play_file)
+enum class TransitionType {
+  NONE,       // coupure franche
+  CROSSFADE,  // fondu enchaîné
+  WIPE,       // le nouveau clip recouvre l'ancien de gauche à droite
+  SLIDE       // le nouveau clip pousse l'ancien vers la gauche
+};
+
+enum class PlaybackMode {
+  FORWARD,
+  REVERSE,
+  PING_PONG
+};
+
+// Entrée de l'index des frames : position des données JPEG dans la source
+struct FrameIndexEntry {
+  uint32_t offset;
+  uint32_t size;
+  uint32_t timestamp;
+};
+
+// Frame décodé (à l'échelle de décodage) conservé pour être réaffiché
+struct CachedFrame {
+  FrameRef frame;
+  uint32_t last_used;
+};
+
+// Sortie supplémentaire : un écran qui affiche une fenêtre de la vidéo
+// (coordonnées en pixels de la vidéo, largeur 0 = vidéo entière)
+struct VideoOutput {
+  display::Display *display;
+  uint16_t src_x;
+  uint16_t src_y;
+  uint16_t src_width;
+  uint16_t src_height;
+};
+
 class VideoPlayerComponent : public Component {
  public:
   void setup() override;
@@ -24,12 +83,108 @@ class VideoPlayerComponent : public Component {
     this->video_path_ = path;
     this->source_ = VideoSource::FILE;
   }
+  // Carte SD : même fichier vu par FatFs ("0:/video.mjpg"), lu secteur par secteur
+  void set_fat_path(const char *path) { this->fat_path_ = path; }
   void set_http_url(const char *url) { 
     this->http_url_ = url;
     this->source_ = VideoSource::HTTP;
   }
   void set_loop(bool loop) { this->loop_video_ = loop; }
+  // Changer de clip (source FILE), avec la transition configurée
+  bool play_file(const std::string &path, const std::string &fat_path = "");
+  void set_transition(TransitionType type, uint32_t duration_ms) {
+    this->transition_type_ = type;
+    this->transition_duration_ = duration_ms;
+  }
   void set_update_interval(uint32_t interval_ms) { this->update_interval_ = interval_ms; }
+  void set_memory_budget(size_t budget);
+  // Débit réseau : poids de la vidéo parmi les clients actifs de l'arbitre et
+  // plafond (0 = sans plafond). Le débit du lien, lui, est global.
+  void set_bandwidth(uint8_t weight, uint32_t max_rate) {
+    this->network_weight_ = weight;
+    this->network_max_rate_ = max_rate;
+  }
+  // Nom du client dans l'arbitre réseau (chaîne statique, unique par lecteur)
+  void set_network_name(const char *name) { this->network_name_ = name; }
+  // Décodeur JPEG : "auto" (micro-benchmark sur les premiers frames), "builtin", "tjpgd" ou "hardware"
+  void set_decoder(const char *name) { this->decoder_name_ = name; }
+  void set_decoder_benchmark_frames(uint8_t frames) { this->benchmark_frames_ = frames; }
+  // Frames décodés en tuiles de 16x16 pixels quand le décodeur sait les écrire
+  void set_tiled_layout(bool tiled) { this->tiled_layout_ = tiled; }
+  void set_hardware_decoder(HardwareDecodeFunction function);
+  const char *get_decoder_name() const { return this->decoder_ ? this->decoder_->get_name() : "none"; }
+  // Pause : plus aucun décodage, mémoire du pipeline rendue (jusqu'au plancher)
+  void pause();
+  void resume();
+  bool is_paused() const { return this->paused_; }
+  void set_keep_last_frame(bool keep) { this->keep_last_frame_ = keep; }
+  void set_idle_memory_floor(size_t floor) { this->idle_memory_floor_ = floor; }
+  // Part maximale du cœur consacrée à la lecture, moyennée sur 1 s (0 = pas de limite)
+  void set_cpu_budget(float budget) { this->cpu_budget_ = budget; }
+  float get_cpu_load() const { return this->cpu_load_; }
+  // Instantané : le JPEG du frame affiché, servi sans décodage
+  void set_snapshot_path(const std::string &path) { this->snapshot_path_ = path; }
+  void set_web_server(web_server_base::WebServerBase *web_server) { this->web_server_ = web_server; }
+  // Appelés depuis la tâche du serveur HTTP ; un échec signale aussi la
+  // demande à la boucle principale, qui prépare alors un instantané
+  bool lock_snapshot(const uint8_t **data, size_t *size);
+  void unlock_snapshot();
+  
+#ifdef USE_SENSOR
+  void set_cpu_load_sensor(sensor::Sensor *sensor) { this->cpu_load_sensor_ = sensor; }
+#endif
+  // Mur d'écrans : chaque frame est décodé une fois puis envoyé à chaque sortie
+  void add_output(display::Display *display, uint16_t src_x, uint16_t src_y, uint16_t src_width,
+                  uint16_t src_height);
+  // Mode mosaïque : ce lecteur n'occupe qu'une cellule de la grille
+  void set_mosaic(uint8_t columns, uint8_t rows, uint8_t cell);
+  void set_band_height(uint16_t rows) { this->band_height_ = rows; }
+  // Réglage automatique de la hauteur de bande et de la disposition des
+  // frames : calibration sur les premiers frames, résultat enregistré en flash
+  void set_autotune(bool autotune, uint8_t frames) {
+    this->autotune_ = autotune;
+    this->autotune_frames_ = frames;
+  }
+  void start_autotune();
+  bool is_autotuning() const { return this->autotune_candidate_ >= 0; }
+  // Sens de lecture ; REVERSE et PING_PONG s'appuient sur l'index des frames
+  void set_playback_mode(PlaybackMode mode) {
+    this->playback_mode_ = mode;
+    this->direction_ = mode == PlaybackMode::REVERSE ? -1 : 1;
+  }
+  // Nombre de frames décodés gardés en cache (0 = désactivé)
+  void set_frame_cache_size(uint8_t size) { this->frame_cache_size_ = size; }
+  // Frames conservés en 8 bits indexés sur la palette de la vidéo (bloc PLTE)
+  void set_palette_mode(bool enabled) { this->palette_mode_ = enabled; }
+  // Vidéo avec masque alpha (bloc ALPH) : couleur de fond pour les bords semi-transparents
+  void set_alpha_matte(uint32_t rgb) { this->alpha_matte_ = rgb565(rgb >> 16, rgb >> 8, rgb); }
+  // Lecture synchronisée entre plusieurs appareils (mur vidéo)
+  void set_sync(SyncRole role, const char *group, uint16_t port) {
+    this->clock_sync_.reset(new ClockSync(role, group, port));
+  }
+  
+  // Déplacement interactif : aperçu DC (1/8) immédiat, pleine qualité à l'arrêt
+  bool scrub_to(uint32_t index);
+  // Bande de vignettes de N frames régulièrement espacés
+  bool draw_thumbnail_strip(int x, int y, int width, int height, uint8_t count);
+  
+  // Réglages d'image appliqués par table pendant la conversion des pixels
+  void set_brightness(float brightness);
+  void set_contrast(float contrast);
+  void set_gamma(float gamma);
+  float get_brightness() const { return this->brightness_; }
+  float get_contrast() const { return this->contrast_; }
+  float get_gamma() const { return this->gamma_; }
+  
+  // Calque de sprites composé pendant le blit (horloge, icônes, barre de progression)
+  void add_overlay(OverlaySprite *sprite) { this->overlays_.push_back(sprite); }
+  
+  // Utilisé par le VideoEngine pour l'ordonnancement
+  bool is_playing() const;
+  uint32_t get_next_deadline() const { return this->last_update_ + this->update_interval_; }
+  // Vrai si le lecteur attend un décodage à ce passage (échéance atteinte,
+  // ni en attente de l'horloge média ni en déplacement)
+  bool is_decode_ready() const { return this->decode_ready_; }
   
   // Destructeur pour nettoyer les ressources
   ~VideoPlayerComponent();
@@ -39,8 +194,95 @@ class VideoPlayerComponent : public Component {
   void init_mutex();
   bool open_file_source();
   bool open_http_source();
+  void http_prefetch();
+  uint32_t autotune_key() const;
+  void autotune_begin();
+  void apply_autotune_candidate(int candidate);
+  void autotune_step(bool presented, int64_t work_us);
+  void close_http_client();
+  void release_http_source();
+  bool grow_http_buffer(size_t capacity);
+  bool http_frame_ready() const;
+  bool parse_chunks();
+  // Blocs d'un flux HTTP ; `frame_header` reçoit les 8 octets du premier frame
+  // déjà lus (`*header_size` vaut 0 si le flux n'a pas de frame)
+  bool parse_http_chunks(esp_http_client_handle_t client, size_t content_length, uint8_t *frame_header,
+                         size_t *header_size);
+  void apply_chunk(uint32_t fourcc, const uint8_t *data, size_t size);
+  void on_chunks_parsed();
+  bool show_poster();
+  void publish_snapshot(const FrameRef &jpeg);
+  void service_snapshot(uint32_t now);
+  void prewarm();
+  void mark_first_frame();
   bool read_next_frame();
-  bool process_frame(const uint8_t* jpeg_data, size_t jpeg_size);
+  bool skip_frame();
+  bool peek_frame_timestamp(uint32_t *timestamp);
+  void rewind();
+  bool sync_frame_due();
+  bool drop_frame();
+  void finish();
+  void init_decoders();
+  void use_rans_codec(const uint8_t *tables, size_t size);
+  bool run_decoder(const uint8_t *jpeg_data, size_t jpeg_size, jpg_scale_t scale, uint8_t *out, uint32_t width,
+                   uint32_t height);
+  void retain_last_frame();
+  void close_file_source();
+  FrameRef capture_outgoing_frame();
+  void update_transition();
+  void transition_row(uint16_t *dst, uint32_t row, uint32_t frame_height, int width);
+  uint16_t apply_color_lut(uint16_t p) const {
+    return (this->lut_r_[p >> 11] << 11) | (this->lut_g_[(p >> 5) & 0x3F] << 5) | this->lut_b_[p & 0x1F];
+  }
+  bool cpu_over_budget() const;
+  void account_cpu(int64_t busy_us);
+  void run_loop(uint32_t now);
+  bool ensure_frame_index();
+  bool index_step(int64_t budget_us);
+  void note_frame_position(uint32_t header_offset, uint32_t size, uint32_t timestamp);
+  void on_index_complete();
+  std::string get_index_path() const;
+  uint32_t compute_index_fingerprint();
+  bool load_frame_index();
+  void save_frame_index();
+  bool present_next_frame();
+  bool present_indexed_frame(uint32_t index);
+  uint32_t step_position();
+  FrameRef read_file_jpeg(uint32_t offset, uint32_t size);
+  long tell_file();
+  void seek_file(long offset);
+  void sync_file_position();
+  FrameRef read_indexed_jpeg(uint32_t index);
+  void seek_position(uint32_t index);
+  FrameRef decode_frame(const FrameRef &jpeg, jpg_scale_t scale);
+  FrameRef decode_full(const FrameRef &jpeg);
+  bool process_frame(const FrameRef &jpeg);
+  CachedFrame *find_cached_frame(uint32_t index);
+  void cache_frame(const FrameRef &frame);
+  void clear_frame_cache();
+  bool blit_frame(const uint8_t *pixels, uint32_t src_width, uint32_t src_height,
+                  PixelFormat format = PixelFormat::RGB565, const uint8_t *alpha = nullptr);
+  bool blit_frame(const FrameRef &frame) {
+    return this->blit_frame(frame.data(), frame.info().width, frame.info().height, frame.info().format,
+                            frame.attached().data());
+  }
+  bool blit_frame_to(const uint8_t *pixels, uint32_t src_width, uint32_t src_height,
+                     int dst_x, int dst_y, int width, int height, PixelFormat format = PixelFormat::RGB565,
+                     const uint8_t *alpha = nullptr);
+  bool blit_region(display::Display *target, const uint8_t *pixels, uint32_t stride, uint32_t frame_height,
+                   uint32_t src_x, uint32_t src_y, uint32_t src_width, uint32_t src_height, int dst_x, int dst_y,
+                   int width, int height, PixelFormat format, const uint8_t *alpha);
+  void convert_row(const uint8_t *pixels, uint32_t row, uint32_t stride, PixelFormat format, uint16_t *dst,
+                   int x_begin, int x_end);
+  void blit_alpha_row(display::Display *target, uint16_t *dst, const uint8_t *pixels, uint32_t row,
+                      uint32_t stride, PixelFormat format, const uint8_t *alpha, int dst_x, int y, int width);
+  FrameRef extract_alpha_mask(const FrameRef &jpeg) const;
+  void schedule_flush();
+  bool build_palette_lut();
+  FrameRef quantize_frame(const FrameRef &rgb);
+  jpg_scale_t select_scale() const;
+  void rebuild_color_lut();
+  void update_viewport();
   void cleanup();
   
   // Composants externes
@@ -49,6 +291,16 @@ class VideoPlayerComponent : public Component {
   // Propriétés de la source vidéo
   const char *video_path_{nullptr};
   const char *http_url_{nullptr};
+  // Lecture directe des frames par plages de secteurs (sinon fread)
+  const char *fat_path_{nullptr};
+  std::unique_ptr<ExtentReader> extent_reader_;
+  // Lecture directe en cours : la position logique est raw_position_ (le FILE
+  // n'est recalé dessus qu'au besoin) et l'en-tête du frame suivant, lu avec
+  // les données du précédent, est gardé dans raw_next_header_
+  bool raw_reading_{false};
+  bool raw_header_valid_{false};
+  uint32_t raw_position_{0};
+  uint8_t raw_next_header_[8];
   VideoSource source_{VideoSource::FILE};
   bool loop_video_{true};
   
@@ -58,23 +310,197 @@ class VideoPlayerComponent : public Component {
   uint32_t frame_count_{0};
   uint32_t video_fps_{30};
   uint32_t current_frame_{0};
+  // Position du premier frame, après l'en-tête et les blocs optionnels
+  uint32_t data_offset_{0};
+  
+  // Image d'attente pré-décodée et mesure du temps jusqu'au premier frame
+  uint32_t poster_offset_{0};
+  uint16_t poster_width_{0};
+  uint16_t poster_height_{0};
+  int64_t setup_start_us_{0};
+  int64_t time_to_first_frame_us_{0};
+  
+  // Zone d'affichage (écran entier ou cellule de mosaïque)
+  uint8_t mosaic_columns_{0};
+  uint8_t mosaic_rows_{0};
+  uint8_t mosaic_cell_{0};
+  int viewport_x_{0};
+  int viewport_y_{0};
+  uint32_t viewport_width_{0};
+  uint32_t viewport_height_{0};
+  uint16_t band_height_{16};
+  std::vector<OverlaySprite *> overlays_;
+  
+  // Tables luminosité / contraste / gamma par canal RGB565, reconstruites
+  // seulement quand un paramètre change
+  float brightness_{0.0f};
+  float contrast_{1.0f};
+  float gamma_{1.0f};
+  bool color_lut_dirty_{false};
+  bool color_lut_active_{false};
+  uint8_t lut_r_[32];
+  uint8_t lut_g_[64];
+  uint8_t lut_b_[32];
+  
+  // Mode palette : palette 256 couleurs fournie par la vidéo, table 3D
+  // 16x16x16 RGB565 -> index, et palette d'affichage (réglages d'image inclus)
+  bool palette_mode_{false};
+  bool has_palette_{false};
+  uint16_t palette_[256];
+  uint16_t palette_out_[256];
+  uint8_t *palette_lut_{nullptr};
+  
+  // Vidéo à masque alpha : profondeur annoncée par le bloc ALPH (0 = pas de masque).
+  // L'écran ne se relit pas : les bords sont mélangés avec une couleur de fond fixe.
+  uint8_t alpha_bits_{0};
+  uint16_t alpha_matte_{0};
+  std::vector<std::pair<int, int>> alpha_segments_;  // segments visibles de la ligne en cours
+  
+  std::vector<uint16_t> x_map_;
+  uint32_t x_map_src_x_{0};
+  uint32_t x_map_src_width_{0};
+  
+  // Écrans supplémentaires alimentés par le même décodage
+  std::vector<VideoOutput> outputs_;
   
   // Timing
   uint32_t update_interval_{0};
   uint32_t last_update_{0};
+  uint32_t frames_dropped_{0};
+  
+  // Décodeurs disponibles et décodeur retenu ; pendant le benchmark, chaque
+  // décodeur traite les mêmes frames (temps cumulé, -1 après un échec)
+  std::vector<std::unique_ptr<DecoderBackend>> decoders_;
+  std::vector<int64_t> decoder_time_us_;
+  DecoderBackend *decoder_{nullptr};
+  HardwareDecodeFunction hardware_decode_;
+  const char *decoder_name_{"auto"};
+  uint8_t benchmark_frames_{3};
+  uint8_t benchmark_frames_left_{0};
+  int64_t decoder_frame_us_{0};
+  // Frames codés par rANS (bloc RANS) plutôt qu'en JPEG
+  bool rans_codec_{false};
+  // Demande de décodage en attente auprès du moteur (voir claim_slot)
+  bool decode_ready_{false};
+  // Frames en tuiles de 16x16 (voir tiled_pixel_index), remis en lignes à l'envoi
+  bool tiled_layout_{false};
+  
+  // Réglage automatique : chaque configuration candidate joue quelques frames
+  // (le premier, qui réserve les buffers, n'est pas compté) ; la plus rapide
+  // est enregistrée avec une clé du contenu et réappliquée au démarrage
+  struct AutotuneResult {
+    uint32_t key;
+    uint16_t band_height;
+    bool tiled;
+    uint32_t frame_us;
+  };
+  bool autotune_{false};
+  bool autotune_pending_{false};
+  bool autotune_force_{false};
+  bool autotune_warmup_{false};
+  uint8_t autotune_frames_{8};
+  uint8_t autotune_frames_left_{0};
+  uint8_t autotune_misses_{0};
+  int autotune_candidate_{-1};
+  int autotune_candidates_{0};
+  int64_t autotune_time_us_{0};
+  AutotuneResult autotune_best_{0, 16, false, UINT32_MAX};
+  ESPPreferenceObject autotune_pref_;
+  
+  // Pause et fin de lecture sans boucle ; le dernier frame peut être conservé
+  // pour redessiner sous les sprites pendant la pause
+  bool paused_{false};
+  bool finished_{false};
+  bool keep_last_frame_{false};
+  size_t idle_memory_floor_{0};
+  int32_t presented_index_{-1};
+  FrameRef last_frame_;
+  
+  // Transition entre clips : dernier frame de l'ancien clip (RGB565), mélangé
+  // dans les bandes du blit avec les frames du nouveau jusqu'à la fin de la durée
+  TransitionType transition_type_{TransitionType::NONE};
+  uint32_t transition_duration_{0};
+  FrameRef transition_from_;
+  uint32_t transition_start_{0};
+  uint32_t transition_alpha_{32};  // part du nouveau clip, 0..32
+  std::vector<uint16_t> transition_x_map_;
+  std::vector<uint16_t> transition_row_;
+  std::string clip_path_;
+  std::string clip_fat_path_;
+  
+  // Gouverneur CPU : temps occupé sur la fenêtre courante, frames sautés et
+  // réduction d'échelle supplémentaire tant que le budget est dépassé
+  float cpu_budget_{0.0f};
+  float cpu_load_{0.0f};
+  int64_t cpu_window_start_us_{0};
+  int64_t cpu_busy_us_{0};
+  // Temps passé à céder la main pendant le passage courant de loop()
+  int64_t loop_yield_us_{0};
+  uint32_t governor_drops_{0};
+  uint32_t governor_window_drops_{0};
+  uint8_t governor_scale_{0};
+#ifdef USE_SENSOR
+  sensor::Sensor *cpu_load_sensor_{nullptr};
+#endif
+  
+  // Index des frames et cache des frames décodés
+  PlaybackMode playback_mode_{PlaybackMode::FORWARD};
+  std::vector<FrameIndexEntry> frame_index_;
+  bool index_complete_{false};
+  uint32_t index_scan_offset_{0};
+  uint32_t next_frame_index_{0};
+  uint32_t frame_position_{0};
+  int8_t direction_{1};
+  uint8_t frame_cache_size_{0};
+  std::vector<CachedFrame> frame_cache_;
+  uint32_t cache_clock_{0};
+  uint32_t cache_hits_{0};
+  
+  // Déplacement interactif
+  bool scrubbing_{false};
+  uint32_t scrub_target_{0};
+  uint32_t last_scrub_{0};
+  
+  // Synchronisation réseau de l'horloge média
+  std::unique_ptr<ClockSync> clock_sync_;
+  uint32_t last_sync_start_attempt_{0};
+  uint32_t frames_held_{0};
   
   // Source FILE
   FILE *video_file_{nullptr};
+  uint32_t file_size_{0};
   bool spiffs_mounted_{false};
   
-  // Source HTTP
+  // Source HTTP : fenêtre glissante du flux, prise dans le pool partagé.
+  // http_stream_offset_ est la position dans le fichier du premier octet du
+  // buffer ; les frames lus sont copiés, le buffer peut donc être compacté.
   uint8_t *http_buffer_{nullptr};
   size_t http_buffer_size_{0};
   size_t http_buffer_size_used_{0};
   size_t http_buffer_pos_{0};
+  size_t http_stream_offset_{0};
+  size_t http_content_length_{0};
+  // Reste d'un frame trop grand pour le buffer, à jeter à la réception
+  size_t http_discard_{0};
+  // Connexion ouverte tant que le téléchargement progressif n'est pas terminé
+  esp_http_client_handle_t http_client_{nullptr};
+  // Client de l'arbitre réseau (voir bandwidth_arbiter.h)
+  const char *network_name_{"video"};
+  int network_client_{-1};
+  uint8_t network_weight_{2};
+  uint32_t network_max_rate_{0};
   
-  // Mutex pour la synchronisation
-  SemaphoreHandle_t network_mutex_{nullptr};
+  // Instantané : référence sur le JPEG présenté (pas de copie). Le mutex
+  // protège l'envoi, fait depuis la tâche du serveur HTTP ; l'ancienne
+  // référence est rendue au pool après le mutex (le pool a son propre verrou).
+  // Sans demande depuis SNAPSHOT_HOLD_MS, aucun bloc du pool n'est retenu.
+  std::string snapshot_path_;
+  web_server_base::WebServerBase *web_server_{nullptr};
+  std::atomic<bool> snapshot_requested_{false};
+  uint32_t last_snapshot_request_{0};
+  SemaphoreHandle_t snapshot_mutex_{nullptr};
+  FrameRef snapshot_jpeg_;
+  size_t snapshot_size_{0};
   
   // Nouvelles variables ajoutées pour la gestion d'initialisation HTTP différée
   bool http_initialized_{false};
@@ -0,0 +1,119 @@
+// Test hôte de la synchronisation d'horloge (clock_sync.cpp) : un leader et
+// un follower dans le même processus, reliés par le multicast en boucle
+// locale. L'horloge du follower est décalée pour vérifier l'estimation de
+// l'écart ; le test vérifie aussi le temps média au-delà de 2^32 ms et la
+// perte de synchronisation quand le leader se tait. Code de sortie non nul en
+// cas d'échec ; dure quelques secondes (une balise par seconde).
+//
+// Compilation et exécution, depuis la racine du dépôt :
+//   g++ -O2 -Wall -std=gnu++17 -Itools/host_benchmark/host -Icomponents/video_player
+//       tools/host_benchmark/clock_sync_loopback.cpp components/video_player/clock_sync.cpp
+//       -o clock_sync_loopback && ./clock_sync_loopback
+//
+// Il faut une interface capable de multicast (IP_MULTICAST_LOOP livre les
+// paquets localement, sans qu'ils quittent la machine).
+
+#include "clock_sync.h"
+
+#include "esp_timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace esphome::video_player;
+
+namespace {
+
+const char *const GROUP = "239.255.42.43";
+const uint16_t PORT = 5143;
+// Décalage de l'horloge du follower : il voit le temps 250 ms en retard
+const int64_t FOLLOWER_SKEW_US = -250000;
+// Tolérances en boucle locale (ordonnanceur de l'hôte compris)
+const int64_t OFFSET_TOLERANCE_US = 5000;
+const int64_t MEDIA_TOLERANCE_MS = 5;
+
+// Horloge décalée, réglable pendant le test
+class SkewedClockSync : public ClockSync {
+ public:
+  SkewedClockSync(SyncRole role, int64_t skew_us) : ClockSync(role, GROUP, PORT), skew_us_(skew_us) {}
+  void set_skew_us(int64_t skew_us) { this->skew_us_ = skew_us; }
+
+ protected:
+  int64_t now_us() const override { return esp_timer_get_time() + this->skew_us_; }
+  int64_t skew_us_;
+};
+
+int failures = 0;
+
+void check(bool condition, const char *what) {
+  printf("%s: %s\n", condition ? "ok  " : "FAIL", what);
+  if (!condition) {
+    failures++;
+  }
+}
+
+// Faire tourner les deux instances comme leurs boucles loop() respectives
+template<typename Done> bool poll_until(ClockSync *a, ClockSync *b, int timeout_ms, Done done) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (a != nullptr) {
+      a->poll();
+    }
+    b->poll();
+    if (done()) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return false;
+}
+
+}  // namespace
+
+int main() {
+  SkewedClockSync leader(SyncRole::LEADER, 0);
+  SkewedClockSync follower(SyncRole::FOLLOWER, FOLLOWER_SKEW_US);
+  if (!leader.start() || !follower.start()) {
+    fprintf(stderr, "Cannot open the multicast sockets (no multicast-capable interface?)\n");
+    return 2;
+  }
+
+  // Première balise, puis un échange de délai : une à deux périodes
+  check(poll_until(&leader, &follower, 4000, [&]() { return follower.is_synced(); }), "follower synchronises");
+  // Quelques échanges de plus pour le filtre au plus petit délai
+  poll_until(&leader, &follower, 2500, []() { return false; });
+
+  char what[96];
+  const int64_t offset_error = llabs(follower.get_offset_us() + FOLLOWER_SKEW_US);
+  snprintf(what, sizeof(what), "offset %lld us (error %lld us, delay %lld us)", (long long) follower.get_offset_us(),
+           (long long) offset_error, (long long) follower.get_delay_us());
+  check(offset_error < OFFSET_TOLERANCE_US, what);
+
+  int64_t leader_ms = 0, follower_ms = 0;
+  const bool both = leader.get_media_time_ms(&leader_ms) && follower.get_media_time_ms(&follower_ms);
+  snprintf(what, sizeof(what), "media time leader %lld ms, follower %lld ms", (long long) leader_ms,
+           (long long) follower_ms);
+  check(both && llabs(leader_ms - follower_ms) <= MEDIA_TOLERANCE_MS, what);
+
+  // 50 jours plus tard : le temps média dépasse 2^32 ms sans revenir à zéro
+  leader.set_skew_us(50LL * 24 * 3600 * 1000000);
+  check(leader.get_media_time_ms(&leader_ms) && leader_ms > (int64_t) UINT32_MAX, "media time past 2^32 ms");
+  leader.set_skew_us(0);
+
+  // Leader arrêté : le follower se désynchronise après quelques balises manquées
+  leader.stop();
+  check(poll_until(nullptr, &follower, 6000, [&]() { return !follower.is_synced(); }),
+        "follower drops sync after missed beacons");
+  check(!follower.get_media_time_ms(&follower_ms), "no media time without a leader");
+
+  // Le leader revient : nouvelle synchronisation
+  check(leader.start() &&
+            poll_until(&leader, &follower, 4000, [&]() { return follower.is_synced(); }),
+        "follower resynchronises");
+
+  printf("%s\n", failures == 0 ? "PASS" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,8 @@
+// Équivalent hôte de diskio.h (voir ff.h)
+#pragma once
+
+#include "ff.h"
+
+typedef enum { RES_OK = 0, RES_ERROR = 1 } DRESULT;
+
+static inline DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count) { return RES_ERROR; }
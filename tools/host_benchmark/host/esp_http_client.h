@@ -0,0 +1,39 @@
+// Équivalent hôte d'esp_http_client.h : aucune connexion n'aboutit, le banc
+// d'essai ne lit que des fichiers
+#pragma once
+
+#include "esp_err.h"
+
+#include <stdbool.h>
+
+typedef struct esp_http_client *esp_http_client_handle_t;
+typedef enum {
+  HTTP_EVENT_ERROR,
+  HTTP_EVENT_ON_CONNECTED,
+  HTTP_EVENT_ON_DATA,
+  HTTP_EVENT_DISCONNECTED
+} esp_http_client_event_id_t;
+typedef struct {
+  esp_http_client_event_id_t event_id;
+  void *data;
+  int data_len;
+  void *user_data;
+} esp_http_client_event_t;
+typedef esp_err_t (*http_event_handle_cb)(esp_http_client_event_t *evt);
+typedef struct {
+  const char *url;
+  http_event_handle_cb event_handler;
+  void *user_data;
+  int timeout_ms;
+  int buffer_size;
+  bool disable_auto_redirect;
+  bool skip_cert_common_name_check;
+} esp_http_client_config_t;
+
+static inline esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config) { return nullptr; }
+static inline esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client) { return ESP_OK; }
+static inline esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len) { return ESP_FAIL; }
+static inline esp_err_t esp_http_client_close(esp_http_client_handle_t client) { return ESP_OK; }
+static inline int esp_http_client_fetch_headers(esp_http_client_handle_t client) { return -1; }
+static inline int esp_http_client_get_status_code(esp_http_client_handle_t client) { return 0; }
+static inline int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len) { return -1; }
@@ -0,0 +1,17 @@
+// Équivalent hôte d'esp_spiffs.h : rien à monter, les fichiers sont lus directement
+#pragma once
+
+#include "esp_err.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+  const char *base_path;
+  const char *partition_label;
+  size_t max_files;
+  bool format_if_mount_failed;
+} esp_vfs_spiffs_conf_t;
+
+static inline esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf) { return ESP_OK; }
+static inline esp_err_t esp_vfs_spiffs_unregister(const char *partition_label) { return ESP_OK; }
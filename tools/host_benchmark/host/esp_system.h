@@ -0,0 +1,7 @@
+// Équivalent hôte d'esp_system.h : pas de suivi du tas sur l'hôte
+#pragma once
+
+#include <stdint.h>
+
+static inline uint32_t esp_get_free_heap_size() { return 0; }
+static inline uint32_t esp_get_minimum_free_heap_size() { return 0; }
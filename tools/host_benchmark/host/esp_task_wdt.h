@@ -0,0 +1,6 @@
+// Équivalent hôte d'esp_task_wdt.h : pas de watchdog sur l'hôte
+#pragma once
+
+#include "esp_err.h"
+
+static inline esp_err_t esp_task_wdt_reset() { return ESP_OK; }
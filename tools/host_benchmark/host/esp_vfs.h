@@ -0,0 +1,2 @@
+// Équivalent hôte d'esp_vfs.h : les chemins sont ceux du système de fichiers de l'hôte
+#pragma once
@@ -0,0 +1,32 @@
+// Équivalent hôte de display::Display : seule l'interface utilisée par le
+// lecteur pour envoyer ses bandes (draw_pixels_at) et rafraîchir (update)
+#pragma once
+
+#include <stdint.h>
+
+namespace esphome {
+namespace display {
+
+enum ColorOrder : uint8_t { COLOR_ORDER_RGB = 0, COLOR_ORDER_BGR = 1, COLOR_ORDER_GRB = 2 };
+enum ColorBitness : uint8_t { COLOR_BITNESS_888 = 0, COLOR_BITNESS_565 = 1, COLOR_BITNESS_332 = 2 };
+
+class Display {
+ public:
+  virtual ~Display() = default;
+  virtual int get_width() { return this->get_width_internal(); }
+  virtual int get_height() { return this->get_height_internal(); }
+  virtual void draw_pixels_at(int x_start, int y_start, int w, int h, const uint8_t *ptr, ColorOrder order,
+                              ColorBitness bitness, bool big_endian, int x_offset, int y_offset, int x_pad) = 0;
+  void draw_pixels_at(int x_start, int y_start, int w, int h, const uint8_t *ptr, ColorOrder order,
+                      ColorBitness bitness, bool big_endian) {
+    this->draw_pixels_at(x_start, y_start, w, h, ptr, order, bitness, big_endian, 0, 0, 0);
+  }
+  virtual void update() {}
+
+ protected:
+  virtual int get_width_internal() = 0;
+  virtual int get_height_internal() = 0;
+};
+
+}  // namespace display
+}  // namespace esphome
@@ -0,0 +1,14 @@
+// Équivalent hôte de color.h : la couleur RGB utilisée par les sprites
+#pragma once
+
+#include <stdint.h>
+
+namespace esphome {
+
+struct Color {
+  uint8_t r{0}, g{0}, b{0}, w{0};
+  Color() = default;
+  Color(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+};
+
+}  // namespace esphome
@@ -0,0 +1,38 @@
+// Équivalent hôte de component.h : le banc d'essai appelle lui-même setup()
+// et les étapes du lecteur ; defer() exécute la fonction tout de suite. Comme
+// sur l'ESP32, les types FreeRTOS arrivent avec cet en-tête.
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <stdint.h>
+#include <functional>
+#include <string>
+
+namespace esphome {
+
+namespace setup_priority {
+const float HARDWARE = 800.0f;
+const float DATA = 600.0f;
+const float PROCESSOR = 400.0f;
+const float LATE = -100.0f;
+}  // namespace setup_priority
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return setup_priority::DATA; }
+  void mark_failed() { this->failed_ = true; }
+  bool is_failed() const { return this->failed_; }
+
+ protected:
+  void defer(const std::string &name, std::function<void()> &&f) { f(); }
+
+  bool failed_{false};
+};
+
+}  // namespace esphome
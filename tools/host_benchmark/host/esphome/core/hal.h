@@ -0,0 +1,12 @@
+// Équivalent hôte de hal.h : millis() sur l'horloge monotone
+#pragma once
+
+#include "esp_timer.h"
+
+#include <stdint.h>
+
+namespace esphome {
+
+inline uint32_t millis() { return (uint32_t) (esp_timer_get_time() / 1000); }
+
+}  // namespace esphome
@@ -0,0 +1,18 @@
+// Équivalent hôte de helpers.h : seules les fonctions utilisées par le lecteur
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+namespace esphome {
+
+inline uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= (uint8_t) c;
+  }
+  return hash;
+}
+
+}  // namespace esphome
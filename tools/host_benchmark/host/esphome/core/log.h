@@ -0,0 +1,25 @@
+// Journalisation hôte : erreurs et avertissements sur stderr, le reste est
+// ignoré. Les formats sont écrits pour l'ESP32 (size_t de 32 bits) : ils ne
+// sont pas vérifiés ici, et les arguments des niveaux ignorés sont tout de
+// même évalués, comme sur la cible.
+#pragma once
+
+#include <stdarg.h>
+#include <stdio.h>
+
+static inline void host_log(const char *level, const char *tag, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  fprintf(stderr, "[%s][%s] ", level, tag);
+  vfprintf(stderr, format, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+static inline void host_log_ignore(const char *tag, const char *format, ...) {}
+
+#define ESP_LOGE(tag, format, ...) host_log("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) host_log("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) host_log_ignore(tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) host_log_ignore(tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) host_log_ignore(tag, format, ##__VA_ARGS__)
+#define ESP_LOGCONFIG(tag, format, ...) host_log_ignore(tag, format, ##__VA_ARGS__)
@@ -0,0 +1,24 @@
+// Équivalent hôte de preferences.h : pas de flash, rien n'est relu d'un
+// démarrage à l'autre
+#pragma once
+
+#include <stdint.h>
+
+namespace esphome {
+
+class ESPPreferenceObject {
+ public:
+  template<typename T> bool save(const T *src) { return false; }
+  template<typename T> bool load(T *dest) { return false; }
+};
+
+class ESPPreferences {
+ public:
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash = false) { return {}; }
+  bool sync() { return true; }
+};
+
+inline ESPPreferences host_preferences;
+inline ESPPreferences *global_preferences = &host_preferences;
+
+}  // namespace esphome
@@ -0,0 +1,41 @@
+// Équivalent hôte de ff.h : pas de FatFs dans le banc d'essai, la lecture
+// directe (fat_path) n'est jamais disponible. Pour tester sd_extents.cpp sur
+// une vraie image FAT, voir sd_extents_fat.cpp (sources de FatFs en tête des
+// chemins d'inclusion).
+#pragma once
+
+// Repéré par sd_extents_fat.cpp, qui refuse de se compiler sans le vrai FatFs
+#define HOST_FATFS_STUB 1
+
+#include <stdint.h>
+
+typedef unsigned int UINT;
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef DWORD LBA_t;
+typedef DWORD FSIZE_t;
+
+#define FF_MIN_SS 512
+#define FF_MAX_SS 512
+#define FA_READ 0x01
+
+typedef enum { FR_OK = 0, FR_DISK_ERR = 1, FR_NO_FILE = 4 } FRESULT;
+typedef struct {
+  BYTE pdrv;
+  BYTE csize;
+} FATFS;
+typedef struct {
+  FATFS *fs;
+  FSIZE_t objsize;
+} FFOBJID;
+typedef struct {
+  FFOBJID obj;
+  LBA_t sect;
+} FIL;
+
+#define f_size(fp) ((fp)->obj.objsize)
+
+static inline FRESULT f_open(FIL *fp, const char *path, BYTE mode) { return FR_NO_FILE; }
+static inline FRESULT f_close(FIL *fp) { return FR_OK; }
+static inline FRESULT f_lseek(FIL *fp, FSIZE_t ofs) { return FR_DISK_ERR; }
@@ -0,0 +1,14 @@
+// Équivalent hôte de FreeRTOS.h : types et constantes utilisés par le lecteur
+#pragma once
+
+#include "esp_system.h"
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xffffffffu
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms))
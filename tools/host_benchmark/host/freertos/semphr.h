@@ -0,0 +1,23 @@
+// Équivalent hôte de semphr.h : les mutex FreeRTOS sont des std::timed_mutex
+#pragma once
+
+#include "FreeRTOS.h"
+
+#include <chrono>
+#include <mutex>
+
+typedef std::timed_mutex *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutex() { return new std::timed_mutex(); }
+static inline void vSemaphoreDelete(SemaphoreHandle_t mutex) { delete mutex; }
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks) {
+  if (ticks == portMAX_DELAY) {
+    mutex->lock();
+    return pdTRUE;
+  }
+  return mutex->try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+  mutex->unlock();
+  return pdTRUE;
+}
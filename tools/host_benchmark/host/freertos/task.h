@@ -0,0 +1,9 @@
+// Équivalent hôte de task.h : un tick vaut une milliseconde
+#pragma once
+
+#include "FreeRTOS.h"
+
+#include <chrono>
+#include <thread>
+
+static inline void vTaskDelay(TickType_t ticks) { std::this_thread::sleep_for(std::chrono::milliseconds(ticks)); }
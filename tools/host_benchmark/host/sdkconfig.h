@@ -0,0 +1,2 @@
+// Pas de cible ESP32 sur l'hôte : pas de tjpgd en ROM
+#pragma once
@@ -0,0 +1,124 @@
+// Écran simulé pour le banc d'essai hôte : les pixels ne sont pas gardés,
+// mais chaque envoi coûte le temps qu'il prendrait sur le bus réel (SPI ou
+// parallèle i80). Le modèle compte le débit du bus, le coût fixe de chaque
+// transaction (file du pilote, CS, lancement du DMA) et la fenêtre
+// d'adressage (CASET, RASET, RAMWR) envoyée avant chaque rectangle.
+//
+// Le bus est synchrone comme draw_pixels_at() sur l'ESP32 : le thread attend
+// la fin du transfert. Les petits envois s'accumulent et l'attente se fait
+// par tranches (ou au rafraîchissement), pour ne pas dépendre de la
+// précision des sommeils très courts de l'hôte.
+//
+// Sans profil de bus, les envois ne coûtent rien, mais les fenêtres et les
+// octets envoyés sont comptés quand même.
+#pragma once
+
+#include "esphome/components/display/display.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace esphome {
+namespace video_player {
+
+struct BusProfile {
+  const char *name;
+  uint32_t bytes_per_second;     // débit utile pendant un transfert
+  uint32_t transaction_ns;       // coût fixe de chaque transaction
+  uint32_t max_transfer;         // octets au plus par transaction (taille DMA)
+  uint8_t window_transactions;   // transactions de la fenêtre d'adressage
+};
+
+// SPI : la ligne D/C change entre commande et paramètres, d'où 5 transactions
+// par fenêtre ; en i80, la commande et ses paramètres partent ensemble
+static const BusProfile BUS_PROFILES[] = {
+    {"spi40", 40000000 / 8, 12000, 32768, 5},
+    {"spi80", 80000000 / 8, 12000, 32768, 5},
+    {"i80-8", 20000000, 4000, 32768, 3},
+    {"i80-16", 40000000, 4000, 32768, 3},
+};
+
+static inline const BusProfile *find_bus_profile(const char *name) {
+  for (const auto &profile : BUS_PROFILES) {
+    if (strcmp(profile.name, name) == 0) {
+      return &profile;
+    }
+  }
+  return nullptr;
+}
+
+class MockBusDisplay : public display::Display {
+ public:
+  MockBusDisplay(const BusProfile *bus, int width, int height) : bus_(bus), width_(width), height_(height) {}
+
+  using display::Display::draw_pixels_at;
+
+  void draw_pixels_at(int x_start, int y_start, int w, int h, const uint8_t *ptr, display::ColorOrder order,
+                      display::ColorBitness bitness, bool big_endian, int x_offset, int y_offset,
+                      int x_pad) override {
+    if (w <= 0 || h <= 0) {
+      return;
+    }
+    const uint32_t bytes_per_pixel = bitness == display::COLOR_BITNESS_888 ? 3
+                                     : bitness == display::COLOR_BITNESS_332 ? 1
+                                                                              : 2;
+    const uint64_t bytes = (uint64_t) w * h * bytes_per_pixel;
+    this->windows_++;
+    this->pixel_bytes_ += bytes;
+    if (this->bus_ == nullptr) {
+      return;
+    }
+    // Fenêtre d'adressage : 3 commandes et 8 octets de coordonnées
+    this->transfer(11, this->bus_->window_transactions);
+    // Pixels, découpés en transactions de la taille DMA au plus
+    this->transfer(bytes, (uint32_t) ((bytes + this->bus_->max_transfer - 1) / this->bus_->max_transfer));
+  }
+
+  // Rafraîchissement : attendre que le bus ait fini le frame
+  void update() override {
+    if (this->bus_ != nullptr) {
+      this->wait_for_bus(std::chrono::nanoseconds(0));
+    }
+  }
+
+  const BusProfile *get_bus() const { return this->bus_; }
+  uint64_t get_busy_ns() const { return this->busy_ns_; }
+  uint64_t get_pixel_bytes() const { return this->pixel_bytes_; }
+  uint64_t get_transactions() const { return this->transactions_; }
+  uint64_t get_windows() const { return this->windows_; }
+
+ protected:
+  int get_width_internal() override { return this->width_; }
+  int get_height_internal() override { return this->height_; }
+
+  void transfer(uint64_t bytes, uint32_t transactions) {
+    const uint64_t cost_ns =
+        (uint64_t) transactions * this->bus_->transaction_ns + bytes * 1000000000ULL / this->bus_->bytes_per_second;
+    this->transactions_ += transactions;
+    this->busy_ns_ += cost_ns;
+    this->free_at_ = std::max(this->free_at_, std::chrono::steady_clock::now()) + std::chrono::nanoseconds(cost_ns);
+    this->wait_for_bus(std::chrono::microseconds(200));
+  }
+
+  void wait_for_bus(std::chrono::nanoseconds slack) {
+    if (this->free_at_ - std::chrono::steady_clock::now() > slack) {
+      std::this_thread::sleep_until(this->free_at_);
+    }
+  }
+
+  const BusProfile *bus_;
+  int width_;
+  int height_;
+  std::chrono::steady_clock::time_point free_at_{};
+  uint64_t busy_ns_{0};
+  uint64_t pixel_bytes_{0};
+  uint64_t transactions_{0};
+  uint64_t windows_{0};
+};
+
+}  // namespace video_player
+}  // namespace esphome
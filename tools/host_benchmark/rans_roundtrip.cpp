@@ -0,0 +1,405 @@
+// Test hôte du codec rANS : une image synthétique est transformée comme le
+// fait l'outil de conversion (YCbCr 4:2:0, DCT, quantification, symboles
+// run/size du JPEG), codée par rANS, puis décodée par le RansDecoderBackend du
+// dépôt à chaque échelle, en lignes et en tuiles. Vérifie aussi le rejet des
+// tables et des frames corrompus. Code de sortie non nul en cas d'échec.
+//
+// Compilation et exécution, depuis la racine du dépôt :
+//   g++ -O2 -Wall -std=gnu++17 -Itools/host_benchmark/host -Icomponents/video_player
+//       tools/host_benchmark/rans_roundtrip.cpp components/video_player/rans_decoder.cpp
+//       -o rans_roundtrip && ./rans_roundtrip
+//
+// Avec -o, le clip codé est aussi écrit dans un conteneur lisible par le
+// lecteur et par stream_benchmark.
+
+#include "rans_decoder.h"
+#include "frame_ref.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace esphome::video_player;
+
+namespace {
+
+const uint32_t CONTAINER_SIGNATURE = 0xFEFFD8FF;
+const uint32_t CHUNK_RANS = 0x534E4152;
+const uint32_t PROB_BITS = 12;
+const uint32_t PROB_SCALE = 1 << PROB_BITS;
+const uint32_t RANS_LOW = 1u << 23;
+
+const uint8_t ZIGZAG[64] = {0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+                            12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+                            35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+                            58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+
+enum { DC_LUMA, AC_LUMA, DC_CHROMA, AC_CHROMA, MODEL_COUNT };
+
+struct Image {
+  uint32_t width;
+  uint32_t height;
+  std::vector<uint8_t> r, g, b;
+};
+
+struct Symbol {
+  uint8_t model;
+  uint8_t value;
+};
+
+// Bits de magnitude bruts, poids fort d'abord
+struct BitWriter {
+  std::vector<uint8_t> out;
+  uint32_t acc{0};
+  int count{0};
+  void put(uint32_t value, int bits) {
+    for (int i = bits - 1; i >= 0; i--) {
+      acc = (acc << 1) | ((value >> i) & 1);
+      if (++count == 8) {
+        out.push_back(acc);
+        acc = 0;
+        count = 0;
+      }
+    }
+  }
+  void flush() {
+    while (count != 0) {
+      put(0, 1);
+    }
+  }
+};
+
+struct Encoded {
+  std::vector<uint8_t> tables;  // contenu du bloc RANS
+  std::vector<uint8_t> frame;
+};
+
+Image make_image(uint32_t width, uint32_t height) {
+  // Dégradés et motif à hautes fréquences, pour remplir les tables AC
+  Image image{width, height, {}, {}, {}};
+  image.r.resize(width * height);
+  image.g.resize(width * height);
+  image.b.resize(width * height);
+  for (uint32_t y = 0; y < height; y++) {
+    for (uint32_t x = 0; x < width; x++) {
+      const size_t i = y * width + x;
+      image.r[i] = x * 255 / width;
+      image.g[i] = y * 255 / height;
+      image.b[i] = ((x / 4 + y / 4) & 1) ? 200 : 60;
+    }
+  }
+  return image;
+}
+
+int category(int value) {
+  value = abs(value);
+  int size = 0;
+  while (value != 0) {
+    size++;
+    value >>= 1;
+  }
+  return size;
+}
+
+uint32_t magnitude_bits(int value, int size) { return value >= 0 ? value : value + (1 << size) - 1; }
+
+Encoded encode(const Image &image, const uint8_t qt[2][64]) {
+  std::vector<Symbol> symbols;
+  BitWriter bits;
+  int pred[3] = {0, 0, 0};
+
+  auto pixel = [&](const std::vector<uint8_t> &plane, uint32_t x, uint32_t y) {
+    return plane[std::min(y, image.height - 1) * image.width + std::min(x, image.width - 1)];
+  };
+  auto luma = [&](uint32_t x, uint32_t y) {
+    return 0.299 * pixel(image.r, x, y) + 0.587 * pixel(image.g, x, y) + 0.114 * pixel(image.b, x, y);
+  };
+  auto chroma = [&](uint32_t x, uint32_t y, bool red) {
+    double sum = 0;
+    for (int dy = 0; dy < 2; dy++) {
+      for (int dx = 0; dx < 2; dx++) {
+        const double r = pixel(image.r, x + dx, y + dy), g = pixel(image.g, x + dx, y + dy),
+                     b = pixel(image.b, x + dx, y + dy);
+        sum += red ? 0.5 * r - 0.418688 * g - 0.081312 * b : -0.168736 * r - 0.331264 * g + 0.5 * b;
+      }
+    }
+    return sum / 4 + 128;
+  };
+  auto block = [&](const double pixels[64], int component) {
+    const bool is_luma = component == 0;
+    double coef[64];
+    for (int v = 0; v < 8; v++) {
+      for (int u = 0; u < 8; u++) {
+        double sum = 0;
+        for (int y = 0; y < 8; y++) {
+          for (int x = 0; x < 8; x++) {
+            sum += (pixels[y * 8 + x] - 128) * cos((2 * x + 1) * u * M_PI / 16) * cos((2 * y + 1) * v * M_PI / 16);
+          }
+        }
+        coef[v * 8 + u] = 0.25 * (u ? 1 : M_SQRT1_2) * (v ? 1 : M_SQRT1_2) * sum;
+      }
+    }
+    int zz[64];
+    for (int k = 0; k < 64; k++) {
+      zz[k] = (int) lround(coef[ZIGZAG[k]] / qt[is_luma ? 0 : 1][k]);
+    }
+    const int diff = zz[0] - pred[component];
+    pred[component] = zz[0];
+    const int dc_size = category(diff);
+    symbols.push_back({(uint8_t) (is_luma ? DC_LUMA : DC_CHROMA), (uint8_t) dc_size});
+    bits.put(magnitude_bits(diff, dc_size), dc_size);
+    int last = 63;
+    while (last > 0 && zz[last] == 0) {
+      last--;
+    }
+    const uint8_t ac_model = is_luma ? AC_LUMA : AC_CHROMA;
+    for (int k = 1, run = 0; k <= last; k++) {
+      if (zz[k] == 0) {
+        run++;
+        continue;
+      }
+      for (; run > 15; run -= 16) {
+        symbols.push_back({ac_model, 0xF0});
+      }
+      const int ac_size = category(zz[k]);
+      symbols.push_back({ac_model, (uint8_t) ((run << 4) | ac_size)});
+      bits.put(magnitude_bits(zz[k], ac_size), ac_size);
+      run = 0;
+    }
+    if (last < 63) {
+      symbols.push_back({ac_model, 0});  // fin de bloc
+    }
+  };
+
+  double pixels[64];
+  for (uint32_t mcu_y = 0; mcu_y < (image.height + 15) / 16; mcu_y++) {
+    for (uint32_t mcu_x = 0; mcu_x < (image.width + 15) / 16; mcu_x++) {
+      for (int b = 0; b < 4; b++) {
+        for (int y = 0; y < 8; y++) {
+          for (int x = 0; x < 8; x++) {
+            pixels[y * 8 + x] = luma(mcu_x * 16 + (b & 1) * 8 + x, mcu_y * 16 + (b >> 1) * 8 + y);
+          }
+        }
+        block(pixels, 0);
+      }
+      for (int component = 1; component <= 2; component++) {
+        for (int y = 0; y < 8; y++) {
+          for (int x = 0; x < 8; x++) {
+            pixels[y * 8 + x] = chroma(mcu_x * 16 + x * 2, mcu_y * 16 + y * 2, component == 2);
+          }
+        }
+        block(pixels, component);
+      }
+    }
+  }
+  bits.flush();
+
+  // Modèles normalisés à 4096, le reste donné au symbole le plus fréquent
+  Encoded encoded;
+  encoded.tables = {1, 0, 0, 0};
+  encoded.tables.insert(encoded.tables.end(), &qt[0][0], &qt[0][0] + 128);
+  uint32_t freq[MODEL_COUNT][256] = {};
+  uint32_t cum[MODEL_COUNT][256];
+  for (const Symbol &symbol : symbols) {
+    freq[symbol.model][symbol.value]++;
+  }
+  for (int m = 0; m < MODEL_COUNT; m++) {
+    uint32_t total = 0;
+    for (int s = 0; s < 256; s++) {
+      total += freq[m][s];
+    }
+    if (total == 0) {
+      freq[m][0] = total = 1;
+    }
+    uint32_t sum = 0;
+    int best = 0;
+    uint16_t count = 0;
+    for (int s = 0; s < 256; s++) {
+      if (freq[m][s] != 0) {
+        freq[m][s] = std::max<uint32_t>(1, (uint64_t) freq[m][s] * PROB_SCALE / total);
+        sum += freq[m][s];
+        count++;
+        if (freq[m][s] > freq[m][best]) {
+          best = s;
+        }
+      }
+    }
+    freq[m][best] += PROB_SCALE - sum;
+    for (uint32_t s = 0, c = 0; s < 256; s++) {
+      cum[m][s] = c;
+      c += freq[m][s];
+    }
+    encoded.tables.push_back(count & 0xFF);
+    encoded.tables.push_back(count >> 8);
+    for (int s = 0; s < 256; s++) {
+      if (freq[m][s] != 0) {
+        encoded.tables.push_back(s);
+        encoded.tables.push_back(freq[m][s] & 0xFF);
+        encoded.tables.push_back(freq[m][s] >> 8);
+      }
+    }
+  }
+
+  // rANS : codage à l'envers, le décodeur lit alors dans l'ordre
+  std::vector<uint8_t> reversed;
+  uint32_t state = RANS_LOW;
+  for (size_t i = symbols.size(); i-- > 0;) {
+    const uint32_t f = freq[symbols[i].model][symbols[i].value];
+    const uint32_t c = cum[symbols[i].model][symbols[i].value];
+    const uint32_t limit = ((RANS_LOW >> PROB_BITS) << 8) * f;
+    while (state >= limit) {
+      reversed.push_back(state & 0xFF);
+      state >>= 8;
+    }
+    state = ((state / f) << PROB_BITS) + (state % f) + c;
+  }
+  const uint32_t rans_size = 4 + reversed.size();
+  auto &frame = encoded.frame;
+  frame = {(uint8_t) (image.width & 0xFF), (uint8_t) (image.width >> 8), (uint8_t) (image.height & 0xFF),
+           (uint8_t) (image.height >> 8)};
+  frame.insert(frame.end(), (const uint8_t *) &rans_size, (const uint8_t *) &rans_size + 4);
+  frame.insert(frame.end(), (const uint8_t *) &state, (const uint8_t *) &state + 4);
+  frame.insert(frame.end(), reversed.rbegin(), reversed.rend());
+  frame.insert(frame.end(), bits.out.begin(), bits.out.end());
+  return encoded;
+}
+
+int failures = 0;
+
+void check(bool condition, const char *what) {
+  printf("%s: %s\n", condition ? "ok  " : "FAIL", what);
+  if (!condition) {
+    failures++;
+  }
+}
+
+bool write_clip(const char *path, const Image &image, const Encoded &encoded, uint32_t frames) {
+  FILE *file = fopen(path, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  const uint32_t header[5] = {CONTAINER_SIGNATURE, image.width, image.height, frames, 30};
+  const uint32_t chunk[2] = {CHUNK_RANS, (uint32_t) encoded.tables.size()};
+  fwrite(header, sizeof(uint32_t), 5, file);
+  fwrite(chunk, sizeof(uint32_t), 2, file);
+  fwrite(encoded.tables.data(), 1, encoded.tables.size(), file);
+  for (uint32_t i = 0; i < frames; i++) {
+    const uint32_t frame_header[2] = {(uint32_t) encoded.frame.size(), i * 1000 / 30};
+    fwrite(frame_header, sizeof(uint32_t), 2, file);
+    fwrite(encoded.frame.data(), 1, encoded.frame.size(), file);
+  }
+  return fclose(file) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const char *clip_path = argc == 3 && strcmp(argv[1], "-o") == 0 ? argv[2] : nullptr;
+  if (argc != 1 && clip_path == nullptr) {
+    fprintf(stderr, "usage: %s [-o clip.mjpg]\n", argv[0]);
+    return 2;
+  }
+
+  // Largeur et hauteur non multiples de 16 : MCU partiels en bord d'image
+  const Image image = make_image(200, 120);
+  uint8_t qt[2][64];
+  memset(qt, 2, sizeof(qt));
+  const Encoded encoded = encode(image, qt);
+  printf("frame: %zu bytes, tables: %zu bytes\n", encoded.frame.size(), encoded.tables.size());
+
+  RansDecoderBackend decoder;
+  check(decoder.load_tables(encoded.tables.data(), encoded.tables.size()), "tables load");
+
+  for (int scale = JPG_SCALE_NONE; scale <= JPG_SCALE_MAX; scale++) {
+    const uint32_t width = image.width >> scale;
+    const uint32_t height = image.height >> scale;
+    std::vector<uint16_t> linear(width * height);
+    // Tuiles entières : le buffer couvre les bords arrondis à 16
+    std::vector<uint16_t> tiled(((width + 15) & ~15u) * ((height + 15) & ~15u));
+    char what[64];
+
+    snprintf(what, sizeof(what), "scale 1/%d decodes", 1 << scale);
+    check(decoder.decode(encoded.frame.data(), encoded.frame.size(), (jpg_scale_t) scale, (uint8_t *) linear.data(),
+                         width, height),
+          what);
+
+    // Écart moyen avec l'image source, moyennée sur le carré de pixels que
+    // couvre chaque sortie (les échelles réduites moyennent, sans repliement)
+    const uint32_t side = 1 << scale;
+    double error = 0;
+    for (uint32_t y = 0; y < height; y++) {
+      for (uint32_t x = 0; x < width; x++) {
+        const uint16_t p = linear[y * width + x];
+        int r = 0, g = 0, b = 0;
+        for (uint32_t sy = 0; sy < side; sy++) {
+          for (uint32_t sx = 0; sx < side; sx++) {
+            const size_t i = ((y << scale) + sy) * image.width + (x << scale) + sx;
+            r += image.r[i];
+            g += image.g[i];
+            b += image.b[i];
+          }
+        }
+        const int count = side * side;
+        error += abs(((p >> 8) & 0xF8) - r / count) + abs(((p >> 3) & 0xFC) - g / count) +
+                 abs(((p << 3) & 0xF8) - b / count);
+      }
+    }
+    error /= 3.0 * width * height;
+    // À 1/4, le damier bleu (carrés de 4 pixels) tombe à la fréquence de
+    // Nyquist de la sortie : l'IDCT réduite, un passe-bas, le rend gris au
+    // lieu de la moyenne exacte de chaque carré
+    const double limit = scale == JPG_SCALE_4X ? 30.0 : 12.0;
+    snprintf(what, sizeof(what), "scale 1/%d mean error %.2f < %.0f", 1 << scale, error, limit);
+    check(error < limit, what);
+
+    snprintf(what, sizeof(what), "scale 1/%d tiled matches linear", 1 << scale);
+    bool same = decoder.decode_tiled(encoded.frame.data(), encoded.frame.size(), (jpg_scale_t) scale,
+                                     (uint8_t *) tiled.data(), width, height);
+    for (uint32_t y = 0; same && y < height; y++) {
+      for (uint32_t x = 0; same && x < width; x++) {
+        same = tiled[tiled_pixel_index(x, y, width)] == linear[y * width + x];
+      }
+    }
+    check(same, what);
+  }
+
+  // Frame tronqué : la taille du flux rANS dépasse les données
+  std::vector<uint16_t> out(image.width * image.height);
+  check(!decoder.decode(encoded.frame.data(), encoded.frame.size() / 4, JPG_SCALE_NONE, (uint8_t *) out.data(),
+                        image.width, image.height),
+        "truncated frame rejected");
+
+  // État initial nul : la renormalisation ne doit pas boucler sans fin
+  std::vector<uint8_t> zero_state = encoded.frame;
+  memset(zero_state.data() + 8, 0, 4);
+  check(!decoder.decode(zero_state.data(), zero_state.size(), JPG_SCALE_NONE, (uint8_t *) out.data(), image.width,
+                        image.height),
+        "initial state zero rejected");
+
+  // Flux rANS coupé court (taille réduite, bits de magnitude intacts) : il
+  // s'épuise avant la fin du frame
+  std::vector<uint8_t> short_stream = encoded.frame;
+  const uint32_t short_size = 8;
+  memcpy(short_stream.data() + 4, &short_size, sizeof(short_size));
+  check(!decoder.decode(short_stream.data(), short_stream.size(), JPG_SCALE_NONE, (uint8_t *) out.data(),
+                        image.width, image.height),
+        "exhausted rANS stream rejected");
+
+  // Fréquences qui ne somment plus à 4096
+  std::vector<uint8_t> corrupt = encoded.tables;
+  corrupt[4 + 128 + 2 + 1]++;
+  RansDecoderBackend rejected;
+  check(!rejected.load_tables(corrupt.data(), corrupt.size()), "corrupt tables rejected");
+  check(!rejected.load_tables(encoded.tables.data(), 16), "short tables rejected");
+
+  if (clip_path != nullptr) {
+    check(write_clip(clip_path, image, encoded, 30), "clip written");
+  }
+
+  printf("%s\n", failures == 0 ? "PASS" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// Test hôte de la lecture directe (sd_extents.cpp) sur une image FAT en
+// mémoire, formatée et remplie par FatFs. Deux fichiers écrits en alternance
+// ont des chaînes de clusters fragmentées, un troisième écrit seul est
+// contigu. Chaque lecture par plages de secteurs doit rendre les octets écrits,
+// en-tête du frame suivant compris, et les lectures hors du fichier doivent
+// être refusées. Code de sortie non nul en cas d'échec.
+//
+// Il faut les sources officielles de FatFs (elm-chan.org, R0.14 ou plus
+// récent) avec FF_USE_MKFS à 1 dans ffconf.h : la table des plages s'appuie
+// sur le f_lseek() de FatFs (chaîne de clusters, secteur courant du FIL), qu'un
+// substitut ne reproduirait pas. La compilation échoue sans elles. Compilation et exécution, depuis la racine
+// du dépôt (FatFs est du C, compilé à part ; son ff.h passe avant l'équivalent
+// de tools/host_benchmark/host) :
+//   gcc -O2 -c $FATFS/ff.c -o ff.o
+//   g++ -O2 -Wall -std=gnu++17 -I$FATFS -Itools/host_benchmark/host -Icomponents/video_player
+//       tools/host_benchmark/sd_extents_fat.cpp components/video_player/sd_extents.cpp
+//       components/video_player/frame_ref.cpp ff.o -o sd_extents_fat && ./sd_extents_fat
+
+#include "sd_extents.h"
+#include "video_engine.h"
+
+#include "ff.h"
+#include "diskio.h"
+
+#ifdef HOST_FATFS_STUB
+#error "sd_extents_fat.cpp needs the FatFs sources ahead of tools/host_benchmark/host in the include path"
+#endif
+#if !FF_USE_MKFS
+#error "sd_extents_fat.cpp needs FF_USE_MKFS set to 1 in ffconf.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+using namespace esphome::video_player;
+
+namespace {
+
+const uint32_t SECTOR_SIZE = 512;
+const uint32_t IMAGE_SECTORS = 16384;  // 8 Mo, assez de clusters pour du FAT16
+const uint32_t CLUSTER_SIZE = 1024;
+const uint32_t FRAGMENTED_SIZE = 600 * 1024;
+const uint32_t CONTIGUOUS_SIZE = 64 * 1024;
+const uint32_t FRAME_HEADER_SIZE = 8;
+
+std::vector<uint8_t> image(IMAGE_SECTORS * SECTOR_SIZE);
+uint32_t disk_reads = 0;
+
+int failures = 0;
+
+void check(bool condition, const char *what) {
+  printf("%s: %s\n", condition ? "ok  " : "FAIL", what);
+  if (!condition) {
+    failures++;
+  }
+}
+
+std::vector<uint8_t> make_content(uint32_t size, uint32_t seed) {
+  std::vector<uint8_t> content(size);
+  std::mt19937 random(seed);
+  for (auto &byte : content) {
+    byte = random();
+  }
+  return content;
+}
+
+bool write_all(FIL *file, const uint8_t *data, uint32_t size) {
+  UINT written = 0;
+  return f_write(file, data, size, &written) == FR_OK && written == size && f_sync(file) == FR_OK;
+}
+
+// Écrire deux fichiers par morceaux alternés : FatFs prend le cluster libre
+// suivant à chaque extension, les chaînes des deux fichiers s'entrelacent
+bool write_interleaved(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b) {
+  FIL file_a, file_b;
+  if (f_open(&file_a, "0:/a.mjpg", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK ||
+      f_open(&file_b, "0:/b.bin", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) {
+    return false;
+  }
+  std::mt19937 random(7);
+  uint32_t pos_a = 0, pos_b = 0;
+  bool ok = true;
+  while (ok && pos_a < a.size()) {
+    // Morceaux de 1 à 6 clusters, pas forcément alignés
+    const uint32_t len_a = std::min<uint32_t>(a.size() - pos_a, CLUSTER_SIZE / 2 + random() % (CLUSTER_SIZE * 6));
+    ok = write_all(&file_a, a.data() + pos_a, len_a);
+    pos_a += len_a;
+    const uint32_t len_b = std::min<uint32_t>(b.size() - pos_b, CLUSTER_SIZE);
+    if (ok && len_b > 0) {
+      ok = write_all(&file_b, b.data() + pos_b, len_b);
+      pos_b += len_b;
+    }
+  }
+  f_close(&file_a);
+  f_close(&file_b);
+  return ok;
+}
+
+bool write_file(const char *path, const std::vector<uint8_t> &content) {
+  FIL file;
+  if (f_open(&file, path, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) {
+    return false;
+  }
+  const bool ok = write_all(&file, content.data(), content.size());
+  f_close(&file);
+  return ok;
+}
+
+// Lecture de `size` octets à `offset` (et de l'en-tête suivant s'il existe),
+// comparée au contenu écrit
+bool read_matches(ExtentReader *reader, const std::vector<uint8_t> &content, uint32_t offset, uint32_t size) {
+  uint8_t tail[FRAME_HEADER_SIZE];
+  const uint32_t tail_size = offset + size + FRAME_HEADER_SIZE <= content.size() ? FRAME_HEADER_SIZE : 0;
+  FrameRef frame = reader->read(offset, size, tail, tail_size);
+  return frame && frame.size() == size && memcmp(frame.data(), content.data() + offset, size) == 0 &&
+         (tail_size == 0 || memcmp(tail, content.data() + offset + size, tail_size) == 0);
+}
+
+}  // namespace
+
+// Pool hôte : le test ne lie pas video_engine.cpp (et donc pas le lecteur)
+namespace esphome {
+namespace video_player {
+VideoEngine::VideoEngine() {}
+VideoEngine *VideoEngine::get() {
+  static VideoEngine engine;
+  return &engine;
+}
+uint8_t *VideoEngine::acquire_buffer(size_t size) { return (uint8_t *) malloc(size); }
+void VideoEngine::release_buffer(uint8_t *buffer) { free(buffer); }
+}  // namespace video_player
+}  // namespace esphome
+
+// Disque FatFs : l'image en mémoire
+extern "C" {
+DSTATUS disk_status(BYTE pdrv) { return pdrv == 0 ? 0 : STA_NOINIT; }
+DSTATUS disk_initialize(BYTE pdrv) { return disk_status(pdrv); }
+DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count) {
+  if (pdrv != 0 || sector + count > IMAGE_SECTORS) {
+    return RES_PARERR;
+  }
+  disk_reads++;
+  memcpy(buff, image.data() + (size_t) sector * SECTOR_SIZE, (size_t) count * SECTOR_SIZE);
+  return RES_OK;
+}
+DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count) {
+  if (pdrv != 0 || sector + count > IMAGE_SECTORS) {
+    return RES_PARERR;
+  }
+  memcpy(image.data() + (size_t) sector * SECTOR_SIZE, buff, (size_t) count * SECTOR_SIZE);
+  return RES_OK;
+}
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff) {
+  switch (cmd) {
+    case CTRL_SYNC:
+      return RES_OK;
+    case GET_SECTOR_COUNT:
+      *(LBA_t *) buff = IMAGE_SECTORS;
+      return RES_OK;
+    case GET_SECTOR_SIZE:
+      *(WORD *) buff = SECTOR_SIZE;
+      return RES_OK;
+    case GET_BLOCK_SIZE:
+      *(DWORD *) buff = 1;
+      return RES_OK;
+  }
+  return RES_PARERR;
+}
+DWORD get_fattime(void) { return ((DWORD) (2024 - 1980) << 25) | (1 << 21) | (1 << 16); }
+}
+
+int main() {
+  FATFS fs;
+  static uint8_t work[FF_MAX_SS * 4];
+  const MKFS_PARM format = {FM_FAT | FM_SFD, 1, 0, 0, CLUSTER_SIZE};
+  if (f_mkfs("0:", &format, work, sizeof(work)) != FR_OK || f_mount(&fs, "0:", 1) != FR_OK) {
+    fprintf(stderr, "Cannot format the FAT image (FF_USE_MKFS must be 1)\n");
+    return 2;
+  }
+  const std::vector<uint8_t> fragmented = make_content(FRAGMENTED_SIZE, 1);
+  const std::vector<uint8_t> other = make_content(FRAGMENTED_SIZE / 4, 2);
+  const std::vector<uint8_t> contiguous = make_content(CONTIGUOUS_SIZE, 3);
+  if (!write_interleaved(fragmented, other) || !write_file("0:/c.bin", contiguous)) {
+    fprintf(stderr, "Cannot write the test files\n");
+    return 2;
+  }
+
+  char what[96];
+  ExtentReader reader;
+  check(reader.open("0:/a.mjpg") && reader.get_file_size() == FRAGMENTED_SIZE, "open fragmented file");
+  snprintf(what, sizeof(what), "fragmented chain resolved into %u extents", (unsigned) reader.get_extent_count());
+  check(reader.get_extent_count() > 16, what);
+
+  // Lectures aléatoires, de quelques octets à 64 Ko (plusieurs plages)
+  std::mt19937 random(11);
+  bool all_match = true;
+  for (int i = 0; i < 2000 && all_match; i++) {
+    const uint32_t offset = random() % (FRAGMENTED_SIZE - 1);
+    const uint32_t size = 1 + random() % std::min<uint32_t>(FRAGMENTED_SIZE - offset, 65536);
+    all_match = read_matches(&reader, fragmented, offset, size);
+    if (!all_match) {
+      snprintf(what, sizeof(what), "read of %u bytes at %u", size, offset);
+    }
+  }
+  check(all_match, all_match ? "2000 random reads match the written data" : what);
+  check(read_matches(&reader, fragmented, 0, FRAGMENTED_SIZE), "whole file in one read");
+  check(read_matches(&reader, fragmented, FRAGMENTED_SIZE - 100, 100), "last bytes, no next header");
+
+  // Une seule requête par lecture tant qu'elle reste dans une plage
+  const uint32_t reads_before = disk_reads;
+  read_matches(&reader, fragmented, 10, 100);
+  check(disk_reads - reads_before == 1, "one disk_read per read within an extent");
+
+  uint8_t tail[FRAME_HEADER_SIZE];
+  check(!reader.read(FRAGMENTED_SIZE - 4, 8), "read past the end refused");
+  check(!reader.read(FRAGMENTED_SIZE - 100, 100, tail, sizeof(tail)), "next header past the end refused");
+  check(!reader.read(0, 0), "empty read refused");
+
+  ExtentReader contiguous_reader;
+  check(contiguous_reader.open("0:/c.bin") && contiguous_reader.get_extent_count() == 1,
+        "contiguous file is a single extent");
+  check(read_matches(&contiguous_reader, contiguous, 1234, CONTIGUOUS_SIZE - 1234 - 100),
+        "contiguous file read");
+
+  ExtentReader missing;
+  check(!missing.open("0:/missing.mjpg"), "missing file refused");
+
+  f_mount(nullptr, "0:", 0);
+  printf("%s\n", failures == 0 ? "PASS" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
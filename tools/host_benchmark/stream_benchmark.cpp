@@ -0,0 +1,292 @@
+// Banc d'essai hôte : K flux vidéo lus en parallèle sur N threads par de vrais
+// VideoPlayerComponent, compilés pour l'hôte avec les équivalents de
+// tools/host_benchmark/host. Lecture du conteneur, choix de l'échelle,
+// décodage (DecoderBackend), envoi par bandes (blit_region) et pool de buffers
+// sont ceux du lecteur. Mesure le débit total, la latence par frame de chaque
+// flux et l'efficacité de 1 thread à tous les cœurs, pour repérer la
+// contention (pool partagé, allocateur, ordonnanceur).
+//
+// Compilation, depuis la racine du dépôt (le C et le C++ séparément) :
+//   gcc -O2 -Wall -std=gnu11 -Itools/host_benchmark/host -Icomponents/video_player
+//       -c components/video_player/esp_jpg_decode.c -o esp_jpg_decode.o
+//   g++ -O2 -Wall -std=gnu++17 -pthread -Itools/host_benchmark/host -Icomponents/video_player
+//       tools/host_benchmark/stream_benchmark.cpp components/video_player/video_player.cpp
+//       components/video_player/video_engine.cpp components/video_player/frame_ref.cpp
+//       components/video_player/decoder_backend.cpp components/video_player/rans_decoder.cpp
+//       components/video_player/overlay.cpp components/video_player/sd_extents.cpp
+//       components/video_player/clock_sync.cpp components/video_player/bandwidth_arbiter.cpp
+//       esp_jpg_decode.o -o stream_benchmark
+//
+// Chaque flux envoie ses frames par blit_region() et draw_pixels_at() à un
+// écran simulé (mock_display.h) qui compte rectangles et octets. Avec --bus,
+// chaque envoi coûte le temps du bus SPI ou i80 réel : les latences incluent
+// alors l'envoi, principal goulet d'étranglement sur l'appareil.
+//
+// Sur l'hôte, seules les vidéos rANS (bloc RANS) sont décodables : les
+// décodeurs JPEG builtin et tjpgd n'existent que sur l'ESP32.
+
+#include "video_player.h"
+#include "video_engine.h"
+#include "mock_display.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace esphome::video_player;
+namespace display = esphome::display;
+
+namespace {
+
+// Pool partagé par tous les flux : de quoi garder les buffers de chacun
+const size_t STREAM_MEMORY = 4 * 1024 * 1024;
+
+struct Options {
+  uint32_t streams{8};
+  uint32_t max_threads{0};
+  uint32_t frames{200};
+  uint32_t width{320};
+  uint32_t height{240};
+  bool tiled{false};
+  const BusProfile *bus{nullptr};
+  uint32_t band_height{16};
+  std::vector<std::string> clips;
+};
+
+// Lecteur piloté frame par frame par le banc d'essai plutôt que par loop()
+class BenchPlayer : public VideoPlayerComponent {
+ public:
+  using VideoPlayerComponent::present_next_frame;
+
+  uint32_t get_decoded_width() const { return this->video_width_ >> this->select_scale(); }
+  uint32_t get_decoded_height() const { return this->video_height_ >> this->select_scale(); }
+};
+
+struct Stream {
+  const std::string *clip{nullptr};
+  std::unique_ptr<MockBusDisplay> display;
+  std::unique_ptr<BenchPlayer> player;
+  std::vector<uint32_t> latencies_us;
+  uint64_t decoded_pixels{0};
+  bool failed{false};
+};
+
+bool open_stream(const std::string *clip, const Options &options, Stream *stream) {
+  stream->clip = clip;
+  // Sans --bus, l'écran compte les envois sans les faire attendre
+  stream->display.reset(new MockBusDisplay(options.bus, options.width, options.height));
+  stream->player.reset(new BenchPlayer());
+  stream->player->set_display(stream->display.get());
+  stream->player->set_file_path(clip->c_str());
+  stream->player->set_band_height(options.band_height);
+  stream->player->set_tiled_layout(options.tiled);
+  // setup() ouvre la vidéo, choisit le décodeur et présente le premier frame
+  stream->player->setup();
+  stream->latencies_us.reserve(options.frames);
+  return !stream->player->is_failed();
+}
+
+// Un frame : lecture -> décodage -> envoi par bandes -> rafraîchissement,
+// chronométré de bout en bout
+bool step_stream(Stream *stream) {
+  const auto start = std::chrono::steady_clock::now();
+  // En fin de fichier, le premier appel revient au début sans présenter
+  const bool ok = stream->player->present_next_frame() || stream->player->present_next_frame();
+  if (ok) {
+    stream->display->update();
+    stream->decoded_pixels += (uint64_t) stream->player->get_decoded_width() * stream->player->get_decoded_height();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  stream->latencies_us.push_back(
+      (uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  return ok;
+}
+
+uint32_t percentile(std::vector<uint32_t> values, double p) {
+  if (values.empty()) {
+    return 0;
+  }
+  const size_t rank = std::min(values.size() - 1, (size_t) (p * (values.size() - 1) + 0.5));
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  return values[rank];
+}
+
+struct RunResult {
+  uint32_t threads;
+  double seconds;
+  uint64_t frames;
+  uint64_t decoded_pixels;
+  std::vector<uint32_t> latencies_us;
+  uint32_t failed_streams;
+  std::vector<std::string> stream_lines;
+};
+
+RunResult run(const Options &options, uint32_t threads) {
+  std::vector<Stream> streams(options.streams);
+  for (uint32_t i = 0; i < options.streams; i++) {
+    if (!open_stream(&options.clips[i % options.clips.size()], options, &streams[i])) {
+      streams[i].failed = true;
+    }
+  }
+
+  // Flux répartis à tour de rôle entre les threads ; chaque thread les fait
+  // avancer frame par frame, comme l'ordonnanceur du lecteur
+  std::atomic<bool> go{false};
+  std::vector<std::thread> workers;
+  for (uint32_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      for (uint32_t frame = 0; frame < options.frames; frame++) {
+        for (uint32_t i = t; i < options.streams; i += threads) {
+          Stream &stream = streams[i];
+          if (!stream.failed && !step_stream(&stream)) {
+            stream.failed = true;
+          }
+        }
+      }
+    });
+  }
+  const auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  RunResult result{threads, seconds, 0, 0, {}, 0, {}};
+  for (uint32_t i = 0; i < options.streams; i++) {
+    Stream &stream = streams[i];
+    if (stream.failed) {
+      result.failed_streams++;
+    }
+    result.frames += stream.latencies_us.size();
+    result.decoded_pixels += stream.decoded_pixels;
+    result.latencies_us.insert(result.latencies_us.end(), stream.latencies_us.begin(), stream.latencies_us.end());
+    // Rectangles et octets envoyés par frame (blit_region), puis part du bus
+    // et transactions par frame
+    char bus[96] = "";
+    if (!stream.latencies_us.empty()) {
+      const MockBusDisplay *display = stream.display.get();
+      const uint64_t frames = stream.latencies_us.size();
+      const int len = snprintf(bus, sizeof(bus), "  %3llu rect, %5llu KB",
+                               (unsigned long long) (display->get_windows() / frames),
+                               (unsigned long long) (display->get_pixel_bytes() / 1024 / frames));
+      if (display->get_bus() != nullptr) {
+        snprintf(bus + len, sizeof(bus) - len, "  bus %6llu us, %3llu tx",
+                 (unsigned long long) (display->get_busy_ns() / 1000 / frames),
+                 (unsigned long long) (display->get_transactions() / frames));
+      }
+    }
+    char line[320];
+    snprintf(line, sizeof(line), "  stream %2u  %-24s %-8s %4ux%-4u  p50 %6u us  p95 %6u us  p99 %6u us%s%s", i,
+             stream.clip->c_str(), stream.player->get_decoder_name(), stream.player->get_decoded_width(),
+             stream.player->get_decoded_height(), percentile(stream.latencies_us, 0.50), percentile(stream.latencies_us, 0.95),
+             percentile(stream.latencies_us, 0.99), bus, stream.failed ? "  FAILED" : "");
+    result.stream_lines.push_back(line);
+  }
+  return result;
+}
+
+void usage(const char *name) {
+  fprintf(stderr,
+          "Usage: %s [options] clip.mjpg...\n"
+          "  -s N              concurrent streams (default 8)\n"
+          "  -t N              maximum threads (default: all cores)\n"
+          "  -f N              frames per stream and run (default 200)\n"
+          "  -w W -h H         display area the frames are scaled to (default 320x240)\n"
+          "  --tiled           decode into 16x16 tiles when the decoder can (tiled_layout)\n"
+          "  --bus NAME        send frames to a display on a modelled bus: spi40, spi80, i80-8, i80-16\n"
+          "  --band N          rows per display transfer (band_height, default 16)\n",
+          name);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "-s" && i + 1 < argc) {
+      options.streams = atoi(argv[++i]);
+    } else if (arg == "-t" && i + 1 < argc) {
+      options.max_threads = atoi(argv[++i]);
+    } else if (arg == "-f" && i + 1 < argc) {
+      options.frames = atoi(argv[++i]);
+    } else if (arg == "-w" && i + 1 < argc) {
+      options.width = atoi(argv[++i]);
+    } else if (arg == "-h" && i + 1 < argc) {
+      options.height = atoi(argv[++i]);
+    } else if (arg == "--tiled") {
+      options.tiled = true;
+    } else if (arg == "--bus" && i + 1 < argc) {
+      options.bus = find_bus_profile(argv[++i]);
+      if (options.bus == nullptr) {
+        usage(argv[0]);
+        return 2;
+      }
+    } else if (arg == "--band" && i + 1 < argc) {
+      options.band_height = atoi(argv[++i]);
+    } else if (arg[0] == '-') {
+      usage(argv[0]);
+      return 2;
+    } else {
+      options.clips.push_back(arg);
+    }
+  }
+  if (options.clips.empty() || options.streams == 0 || options.frames == 0 || options.width == 0 ||
+      options.height == 0 || options.band_height == 0) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  VideoEngine::get()->set_memory_budget(options.streams * STREAM_MEMORY);
+
+  const uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+  const uint32_t max_threads = std::min(options.max_threads ? options.max_threads : cores, options.streams);
+  std::vector<uint32_t> thread_counts;
+  for (uint32_t n = 1; n < max_threads; n *= 2) {
+    thread_counts.push_back(n);
+  }
+  thread_counts.push_back(max_threads);
+
+  printf("%u streams, %u frames each, scaled to %ux%u, %u cores, %u-row bands%s", options.streams, options.frames,
+         options.width, options.height, cores, options.band_height, options.tiled ? ", tiled" : "");
+  if (options.bus != nullptr) {
+    printf(", %s bus", options.bus->name);
+  }
+  printf("\n");
+  printf("threads  Mpixel/s  efficiency  p50 us  p95 us  p99 us\n");
+  double single_rate = 0;
+  for (uint32_t threads : thread_counts) {
+    RunResult result = run(options, threads);
+    if (result.failed_streams == options.streams) {
+      fprintf(stderr, "No stream could be decoded (only rANS clips decode on the host)\n");
+      return 1;
+    }
+    const double rate = result.decoded_pixels / result.seconds / 1e6;
+    if (threads == 1) {
+      single_rate = rate;
+    }
+    printf("%7u  %8.2f  %9.0f%%  %6u  %6u  %6u%s\n", threads, rate,
+           single_rate > 0 ? 100.0 * rate / (single_rate * threads) : 0.0, percentile(result.latencies_us, 0.50),
+           percentile(result.latencies_us, 0.95), percentile(result.latencies_us, 0.99),
+           result.failed_streams ? "  (some streams failed)" : "");
+    if (threads == thread_counts.back()) {
+      printf("Per stream at %u threads:\n", threads);
+      for (const auto &line : result.stream_lines) {
+        printf("%s\n", line.c_str());
+      }
+    }
+  }
+  return 0;
+}